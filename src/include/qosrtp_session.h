@@ -5,12 +5,14 @@
 #else
 #error "Unsupported compiler"
 #endif
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
 
 #include "define.h"
 #include "result.h"
+#include "rtp_frame.h"
 #include "rtp_packet.h"
 
 namespace qosrtp {
@@ -22,6 +24,105 @@ enum class QOSRTP_API MediaTransmissionDirection {
   kRecvOnly
 };
 
+enum class QOSRTP_API MediaType { kAudio, kVideo };
+
+// How QosrtpSession::SendFrame cuts a frame into rtp payloads.
+enum class QOSRTP_API RtpPacketization {
+  kGeneric,  // consecutive pieces of about equal size
+  kH264,     // RFC 6184 Annex-B access unit, single NAL unit and FU-A packets
+  kOpus      // RFC 7587, the frame is one Opus packet
+};
+
+// For QosrtpSession::SendRtpPackets and SendFrame.
+struct QOSRTP_API FrameSendOptions {
+  // The frame is dropped rather than sent after it, 0 for no deadline. Its
+  // packets are not retransmitted after it either.
+  uint64_t deadline_utc_ms = 0;
+  // Nothing refers to the frame, e.g. a non-reference video frame. Once the
+  // queued packets would make a frame miss its deadline, the droppable ones
+  // are dropped first. A frame is dropped whole, the packets of it already
+  // sent are not retransmitted either.
+  bool droppable = false;
+};
+
+// The receive side of a media session, see
+// QosrtpSession::GetReceiveStatistics.
+struct QOSRTP_API MediaReceiveStatistics {
+  static constexpr uint32_t kNbLossPatternBuckets = 16;
+  uint32_t remote_ssrc = 0;
+  // As reported in the rtcp receiver reports, the jitter in rtp timestamp
+  // units.
+  uint32_t cumulative_loss = 0;
+  uint32_t extended_seq_num = 0;
+  uint32_t first_extended_seq_num = 0;
+  uint32_t interarrival_jitter = 0;
+  // Losses not nacked because the retransmission would arrive too late, the
+  // nacked seqs, and the nacked ones whose original packet arrived late
+  // instead of being lost.
+  uint32_t suppressed_nacks = 0;
+  uint32_t nacked_seqs = 0;
+  uint32_t spurious_nacks = 0;
+  // Dropped or released early to keep the packet cache within its budget.
+  uint32_t evicted_frames = 0;
+  uint32_t evicted_packets = 0;
+  uint64_t evicted_bytes = 0;
+  uint32_t early_released_packets = 0;
+  // Times the delivery lag went over the catch-up threshold, the packets
+  // dropped until a key frame resumed delivery, and the key frames
+  // requested, see MediaSessionConfig::SetCatchUpThreshold.
+  uint32_t catch_ups = 0;
+  uint32_t catch_up_dropped_packets = 0;
+  uint32_t key_frame_requests = 0;
+  // burst_lengths[i] counts runs of i + 1 lost packets, the last bucket also
+  // the longer runs.
+  std::array<uint32_t, kNbLossPatternBuckets> burst_lengths = {};
+  // gap_lengths[i] counts runs of [2^i, 2^(i+1)) received packets.
+  std::array<uint32_t, kNbLossPatternBuckets> gap_lengths = {};
+  // reorder_depths[i] counts original packets that arrived [2^i, 2^(i+1))
+  // seqs after a higher seq.
+  std::array<uint32_t, kNbLossPatternBuckets> reorder_depths = {};
+  uint32_t max_reorder_depth = 0;
+  uint32_t duplicates = 0;
+  // Packets that arrived after the receiver stopped waiting for them.
+  uint32_t late_arrivals = 0;
+  // Gilbert-Elliott model of the losses as in RFC 3611 4.7.2.
+  double gap_to_burst_probability = 0;
+  double burst_to_gap_probability = 0;
+  double gap_loss_density = 0;
+  double burst_loss_density = 0;
+};
+
+// The send side of a media session, see QosrtpSession::GetSendStatistics.
+struct QOSRTP_API MediaSendStatistics {
+  // Buckets of [0, 1), [1, 2), [2, 4) ... [512, inf) ms.
+  static constexpr uint32_t kNbQueueDelayBuckets = 11;
+  // Nacked seqs found in the send history, and the ones already dropped
+  // from it, see RtxConfig::SetHistoryBounds.
+  uint32_t history_hits = 0;
+  uint32_t history_misses = 0;
+  uint32_t history_packets = 0;
+  uint32_t history_bytes = 0;
+  uint32_t history_duration_ms = 0;
+  uint32_t rtx_packets = 0;
+  uint32_t rtx_bytes = 0;
+  // Nacked seqs not retransmitted, because they were less than an rtt ago,
+  // because of the rtx bitrate cap, because their frame was past its
+  // deadline, or because their frame was dropped on its way to the network.
+  uint32_t rtx_suppressed = 0;
+  uint32_t rtx_rate_limited = 0;
+  uint32_t rtx_expired = 0;
+  uint32_t rtx_dropped = 0;
+  // Frames past their deadline before they were sequenced, and packets
+  // dropped later on, past their deadline or droppable, see
+  // FrameSendOptions.
+  uint32_t frames_dropped_expired = 0;
+  uint32_t packets_dropped_expired = 0;
+  uint32_t packets_dropped_droppable = 0;
+  // The time the sent packets waited between the call that sent them and
+  // the network.
+  std::array<uint32_t, kNbQueueDelayBuckets> queue_delay_histogram = {};
+};
+
 class QOSRTP_API TransportAddress {
  public:
   static std::unique_ptr<TransportAddress> Create(std::string ip, uint16_t port,
@@ -56,6 +157,21 @@ class QOSRTP_API RtxConfig {
       uint8_t rtx_pt, uint8_t associated_pt) = 0;
   virtual void DeleteRtxAndAssociatedPayloadType(uint8_t rtx_pt) = 0;
   virtual void ClearRtxPayload() = 0;
+  /**
+   * Optional, only used for the local rtx config. The sent packets are kept
+   * for retransmission for three round trip times, at least
+   * min_duration_ms, and the oldest are dropped earlier to stay within
+   * max_bytes. max_cache_seq_difference then only sizes the history at
+   * first. 0 keeps the default of either.
+   */
+  virtual void SetHistoryBounds(uint16_t min_duration_ms,
+                                uint32_t max_bytes) = 0;
+  /**
+   * Optional, only used for the local rtx config. Caps the rtx bitrate at
+   * max_percent of the media bitrate, the nacked packets over it are not
+   * retransmitted. 0 (the default) does not cap it.
+   */
+  virtual void SetMaxBitrateRatio(uint16_t max_percent) = 0;
   /**
    * call
    * SetRtxAndAssociatedPayloadType\DeleteRtxAndAssociatedPayloadType\ClearRtxPayload
@@ -63,12 +179,33 @@ class QOSRTP_API RtxConfig {
    */
   virtual const std::map<uint8_t, uint8_t>& map_rtx_payload_type() const = 0;
   virtual uint16_t max_cache_seq_difference() const = 0;
+  virtual uint16_t history_min_duration_ms() const = 0;
+  virtual uint32_t history_max_bytes() const = 0;
+  virtual uint16_t max_bitrate_percent() const = 0;
   virtual uint32_t ssrc() const = 0;
 };
 
 class QOSRTP_API MediaSessionCallback {
  public:
   virtual void OnRtpPacket(std::vector<std::unique_ptr<RtpPacket>> packets) = 0;
+  /**
+   * Called instead of OnRtpPacket when frame assembly is enabled, with the
+   * frames completed since the last call.
+   */
+  virtual void OnRtpFrames(std::vector<std::unique_ptr<RtpFrame>> frames);
+  /**
+   * Optional, tells whether decoding can resume at the packet while the
+   * receiver catches up, see MediaSessionConfig::SetCatchUpThreshold. Only
+   * asked when no video codec is set, on the worker thread. The default
+   * returns true, so delivery resumes at the first packet that is no longer
+   * late.
+   */
+  virtual bool IsKeyFrameStart(const RtpPacket* packet);
+  /**
+   * Optional, the remote asked for a key frame, the next frame sent should
+   * be one.
+   */
+  virtual void OnKeyFrameRequested();
 
  protected:
   MediaSessionCallback();
@@ -91,6 +228,66 @@ class QOSRTP_API MediaSessionConfig {
       const uint16_t* max_cache_duration_ms,
       MediaTransmissionDirection direction, int rtcp_report_interval_ms,
       MediaSessionCallback* callback) = 0;
+  /**
+   * Optional, the expected bitrate of the remote media, used to size the
+   * receive packet cache. 0 (the default) lets the receiver choose.
+   */
+  virtual void SetExpectedReceiveBitrate(uint32_t bitrate_bps) = 0;
+  /**
+   * Optional, the most bytes the receive packet cache may hold. Over it the
+   * oldest frames with a missing packet are dropped first, then the oldest
+   * packets are delivered early. 0 (the default) derives it from the
+   * expected bitrate.
+   */
+  virtual void SetReceiveCacheByteBudget(uint32_t max_bytes) = 0;
+  /**
+   * Optional, lets the receive jitter buffer adapt its delay between
+   * min_delay_ms and max_delay_ms from the measured jitter, reordering, loss
+   * and rtt. Without it every packet is held for max_cache_duration_ms.
+   */
+  virtual std::unique_ptr<Result> SetJitterBufferDelayBounds(
+      uint16_t min_delay_ms, uint16_t max_delay_ms) = 0;
+  /**
+   * Optional, groups the received packets by timestamp and delivers whole
+   * frames through MediaSessionCallback::OnRtpFrames. Disabled by default.
+   */
+  virtual void EnableFrameAssembly(bool enabled) = 0;
+  /**
+   * Optional, the codec of the remote video. With kH264 or kH265 the frames
+   * delivered through MediaSessionCallback::OnRtpFrames also carry their
+   * Annex-B bitstream, see RtpFrame::bitstream. Implies frame assembly.
+   */
+  virtual void SetVideoCodec(RtpVideoCodec codec) = 0;
+  /**
+   * Optional, once the received media is delivered more than threshold_ms
+   * later than usual, e.g. after a stall, the stale media is dropped up to
+   * the next key frame and a key frame is requested from the remote. Key
+   * frames are found from the payload with a video codec set, through
+   * MediaSessionCallback::IsKeyFrameStart otherwise. Should be well above
+   * the jitter buffer delay. 0 (the default) disables it.
+   */
+  virtual void SetCatchUpThreshold(uint32_t threshold_ms) = 0;
+  /**
+   * Optional, the kind of the local media. With pacing, see
+   * QosrtpSessionConfig::SetPacing, audio is sent before video. kVideo by
+   * default.
+   */
+  virtual void SetLocalMediaType(MediaType type) = 0;
+  /**
+   * Optional, the payload type of the local fec packets, one of the local
+   * rtp payload types. With pacing they are sent after the media and the
+   * rtx packets.
+   */
+  virtual std::unique_ptr<Result> SetLocalFecPayloadType(uint8_t fec_pt) = 0;
+  /**
+   * Optional, the sequence numbers and the rtp timestamps of the sent
+   * packets are assigned by the library, see QosrtpSession::SendRtpPackets,
+   * so several threads can send without ordering the packets themselves.
+   * The ones set on the packets are ignored, except that the packets of one
+   * call protected by its fec packets must be numbered consecutively in the
+   * order given. Disabled by default.
+   */
+  virtual void EnableAutoSequencing(bool enabled) = 0;
 
   virtual uint32_t ssrc_media_local() const = 0;
   virtual const RtxConfig* rtx_config_local() const = 0;
@@ -102,6 +299,18 @@ class QOSRTP_API MediaSessionConfig {
   virtual uint32_t rtp_clock_rate_hz_remote() const = 0;
   virtual const std::vector<uint8_t>& rtp_payload_types_remote() const = 0;
   virtual uint16_t max_cache_duration_ms() const = 0;
+  virtual uint32_t expected_receive_bitrate_bps() const = 0;
+  virtual uint32_t receive_cache_max_bytes() const = 0;
+  // Both 0 if not set.
+  virtual uint16_t jitter_buffer_min_delay_ms() const = 0;
+  virtual uint16_t jitter_buffer_max_delay_ms() const = 0;
+  virtual bool frame_assembly_enabled() const = 0;
+  virtual RtpVideoCodec video_codec() const = 0;
+  virtual uint32_t catch_up_threshold_ms() const = 0;
+  virtual MediaType media_type_local() const = 0;
+  // -1 if not set.
+  virtual int fec_payload_type_local() const = 0;
+  virtual bool auto_sequencing_enabled() const = 0;
 
   virtual MediaTransmissionDirection direction() const = 0;
 
@@ -128,10 +337,27 @@ class QOSRTP_API QosrtpSessionConfig {
       std::unique_ptr<MediaSessionConfig> config) = 0;
   virtual void DeleteMediaSessionConfig(std::string name) = 0;
   virtual void ClearMediaSessionConfig() = 0;
+  /**
+   * Optional, sends the rtp and rtx packets of all the media sessions at
+   * rate_bps on average instead of in bursts, at most burst_bytes at once.
+   * Audio goes first, then video, rtx, fec and padding. 0 for burst_bytes
+   * uses a default, 0 for rate_bps (the default) disables pacing.
+   */
+  virtual void SetPacing(uint32_t rate_bps, uint32_t burst_bytes) = 0;
+  /**
+   * Optional, with pacing, leaves the spacing of the packets to the os
+   * (qWAVE flow shaping on Windows) so the network thread only wakes up
+   * every few milliseconds to hand it the next burst. Falls back to pacing
+   * in user space if the os refuses. Disabled by default.
+   */
+  virtual void EnableKernelPacing(bool enabled) = 0;
 
   virtual TransportAddress* address_local() const = 0;
   virtual TransportAddress* address_remote() const = 0;
   virtual const std::string& cname() const = 0;
+  virtual uint32_t pacing_rate_bps() const = 0;
+  virtual uint32_t pacing_burst_bytes() const = 0;
+  virtual bool kernel_pacing_enabled() const = 0;
   /**
    * call AddMediaSessionConfig and DeleteMediaSessionConfig
    * may change this return map
@@ -147,6 +373,47 @@ class QOSRTP_API QosrtpSession {
   virtual ~QosrtpSession();
   virtual std::unique_ptr<Result> StartSession(
       std::unique_ptr<QosrtpSessionConfig> config) = 0;
+  /**
+   * With MediaSessionConfig::EnableAutoSequencing the packet is sent as a
+   * frame of its own, with the rtp timestamp of the time it is called. The
+   * packets of a frame split over several packets must go through
+   * SendRtpPackets or SendFrame to share one timestamp.
+   */
   virtual void SendRtpPacket(std::unique_ptr<RtpPacket> pkt) = 0;
+  /**
+   * Sends the packets of one frame, all of the same ssrc, in order. With
+   * MediaSessionConfig::EnableAutoSequencing they get consecutive sequence
+   * numbers and the rtp timestamp of capture_time_utc_ms, the fec packets
+   * among them are updated to match, the packets are dropped if the fec
+   * packets protect any not given with them. capture_time_utc_ms is
+   * ignored otherwise.
+   */
+  virtual void SendRtpPackets(std::vector<std::unique_ptr<RtpPacket>> packets,
+                              uint64_t capture_time_utc_ms,
+                              const FrameSendOptions& options) = 0;
+  /**
+   * Cuts the frame into rtp packets of at most mtu bytes, rtp header
+   * included, and sends them like SendRtpPackets. The payloads are slices
+   * of the frame, nothing is copied. The marker bit is set on the last
+   * packet of a video frame. Needs MediaSessionConfig::EnableAutoSequencing
+   * for the media session of ssrc.
+   */
+  virtual std::unique_ptr<Result> SendFrame(
+      uint32_t ssrc, std::unique_ptr<DataBuffer> frame, uint8_t payload_type,
+      RtpPacketization packetization, uint16_t mtu,
+      uint64_t capture_time_utc_ms, const FrameSendOptions& options) = 0;
+  /**
+   * Fills statistics for the media session whose local ssrc is ssrc. Fails
+   * if the media session does not receive or has not received any rtp
+   * packet yet.
+   */
+  virtual std::unique_ptr<Result> GetReceiveStatistics(
+      uint32_t ssrc, MediaReceiveStatistics& statistics) = 0;
+  /**
+   * Fills statistics for the media session whose local ssrc is ssrc. Fails
+   * if the media session does not send.
+   */
+  virtual std::unique_ptr<Result> GetSendStatistics(
+      uint32_t ssrc, MediaSendStatistics& statistics) = 0;
 };
 }  // namespace qosrtp
\ No newline at end of file
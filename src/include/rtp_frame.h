@@ -0,0 +1,35 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "define.h"
+#include "rtp_packet.h"
+
+namespace qosrtp {
+enum class RtpVideoCodec {
+  kNone = 0,
+  kH264,  // RFC 6184, single NAL unit, STAP-A and FU-A packets
+  kH265,  // RFC 7798 without DONL, single NAL unit, AP and FU packets
+};
+
+// The received rtp packets that share one timestamp, the seq of the packets
+// "increases" with index.
+class QOSRTP_API RtpFrame {
+ public:
+  RtpFrame();
+  virtual ~RtpFrame();
+  virtual uint32_t timestamp() const = 0;
+  // True if packets of the frame were lost and could not be recovered before
+  // the frame's deadline, the frame only holds the packets received.
+  virtual bool missing() const = 0;
+  virtual uint32_t nb_packets() const = 0;
+  virtual const RtpPacket* packet(uint32_t index) const = 0;
+  // The NAL units of the frame in one buffer, each preceded by an Annex-B
+  // start code. nullptr unless a video codec is configured for the session,
+  // and for missing frames or frames with malformed payloads. The buffer is
+  // owned by the frame and reused for later frames once the frame is gone.
+  virtual const DataBuffer* bitstream() const = 0;
+  /* use std::move */
+  virtual std::vector<std::unique_ptr<RtpPacket>> TakePackets() = 0;
+};
+}  // namespace qosrtp
\ No newline at end of file
@@ -36,12 +36,23 @@ UdpNetworkTranceiver::UdpNetworkTranceiver()
 #if defined(_MSC_VER)
       sockfd_(INVALID_SOCKET),
       local_address_(),
-      remote_address_()
+      remote_address_(),
+      qos_handle_(nullptr),
+      qos_flow_id_(0)
 #endif
 {
 }
 
-UdpNetworkTranceiver::~UdpNetworkTranceiver() = default;
+UdpNetworkTranceiver::~UdpNetworkTranceiver() {
+#if defined(_MSC_VER)
+  if (nullptr != qos_handle_) {
+    if (0 != qos_flow_id_) {
+      QOSRemoveSocketFromFlow(qos_handle_, sockfd_, qos_flow_id_, 0);
+    }
+    QOSCloseHandle(qos_handle_);
+  }
+#endif
+}
 
 std::unique_ptr<Result> UdpNetworkTranceiver::BuildSocketAndConnect(
     TransportAddress* local_address, TransportAddress* remote_address,
@@ -111,6 +122,81 @@ void UdpNetworkTranceiver::Send(std::unique_ptr<DataBuffer> data_buffer,
     SessionStates::GetInstance()->NotifyByeSent();
 }
 
+void UdpNetworkTranceiver::Send(const NetworkSendBuffer* buffers,
+                                uint32_t nb_buffers) {
+  if ((0 == nb_buffers) || (nb_buffers > kMaxSendBuffers)) {
+    QOSRTP_LOG(Error, "Invalid number of buffers to send: %u", nb_buffers);
+    return;
+  }
+#if defined(_MSC_VER)
+  WSABUF wsa_buffers[kMaxSendBuffers];
+  for (uint32_t i = 0; i < nb_buffers; ++i) {
+    wsa_buffers[i].len = buffers[i].size;
+    wsa_buffers[i].buf =
+        reinterpret_cast<char*>(const_cast<uint8_t*>(buffers[i].data));
+  }
+  DWORD nb_bytes_sent = 0;
+  int ret = WSASendTo(sockfd_, wsa_buffers, nb_buffers, &nb_bytes_sent, 0,
+                      &remote_address_, sizeof(remote_address_), nullptr,
+                      nullptr);
+  if (ret == SOCKET_ERROR) {
+    QOSRTP_LOG(Error, "Error sending data");
+  }
+#endif
+}
+
+std::unique_ptr<Result> UdpNetworkTranceiver::SetKernelPacingRate(
+    uint32_t rate_bps) {
+#if defined(_MSC_VER)
+  if (INVALID_SOCKET == sockfd_) {
+    return Result::Create(-1, "The socket has not been built");
+  }
+  if (0 == rate_bps) {
+    if (0 != qos_flow_id_) {
+      QOSRemoveSocketFromFlow(qos_handle_, sockfd_, qos_flow_id_, 0);
+      qos_flow_id_ = 0;
+    }
+    return Result::Create();
+  }
+  std::stringstream result_description;
+  if (nullptr == qos_handle_) {
+    QOS_VERSION version;
+    version.MajorVersion = 1;
+    version.MinorVersion = 0;
+    if (!QOSCreateHandle(&version, &qos_handle_)) {
+      qos_handle_ = nullptr;
+      result_description << "QOSCreateHandle failed with error code: "
+                         << GetLastError();
+      return Result::Create(-1, result_description.str());
+    }
+  }
+  if (0 == qos_flow_id_) {
+    // Only a non adaptive flow accepts an outgoing rate.
+    if (!QOSAddSocketToFlow(qos_handle_, sockfd_, &remote_address_,
+                            QOSTrafficTypeAudioVideo, QOS_NON_ADAPTIVE_FLOW,
+                            &qos_flow_id_)) {
+      qos_flow_id_ = 0;
+      result_description << "QOSAddSocketToFlow failed with error code: "
+                         << GetLastError();
+      return Result::Create(-1, result_description.str());
+    }
+  }
+  QOS_FLOWRATE_OUTGOING flow_rate;
+  flow_rate.Bandwidth = rate_bps;
+  flow_rate.ShapingBehavior = QOSShapeOnly;
+  flow_rate.Reason = QOSFlowRateNotApplicable;
+  if (!QOSSetFlow(qos_handle_, qos_flow_id_, QOSSetOutgoingRate,
+                  sizeof(flow_rate), &flow_rate, 0, nullptr)) {
+    result_description << "QOSSetFlow failed with error code: "
+                       << GetLastError();
+    return Result::Create(-1, result_description.str());
+  }
+  return Result::Create();
+#else
+  return Result::Create(-1, "Kernel pacing is not supported");
+#endif
+}
+
 void UdpNetworkTranceiver::OnEvent(uint32_t ff, int err) {
   if ((0 == (ff & static_cast<uint32_t>(NetworkIOEvent::kRead)))) {
     QOSRTP_LOG(Warning, "Warning: Received an unexpected event with code");
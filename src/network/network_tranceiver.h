@@ -1,5 +1,8 @@
 #pragma once
 #include <memory>
+#if defined(_MSC_VER)
+#include <qos2.h>
+#endif
 
 #include "../include/data_buffer.h"
 #include "../include/qosrtp_session.h"
@@ -9,6 +12,12 @@
 namespace qosrtp {
 class RtpRtcpPacketDemuxer;
 
+// One piece of a datagram sent by gathering several buffers.
+struct NetworkSendBuffer {
+  const uint8_t* data;
+  uint32_t size;
+};
+
 class NetworkTranceiver {
  public:
   static std::unique_ptr<NetworkTranceiver> Create(TransportProtocolType type);
@@ -18,6 +27,13 @@ class NetworkTranceiver {
       TransportAddress* local_address, TransportAddress* remote_address,
       NetworkIoScheduler* scheduler, RtpRtcpPacketDemuxer* demuxer) = 0;
   virtual void Send(std::unique_ptr<DataBuffer> data_buffer, bool is_bye = false) = 0;
+  // Sends the buffers as one datagram without copying them together, at
+  // most kMaxSendBuffers.
+  virtual void Send(const NetworkSendBuffer* buffers, uint32_t nb_buffers) = 0;
+  // Lets the os space the sent datagrams out to rate_bps, 0 stops it. Fails
+  // where the os cannot shape the traffic of the socket.
+  virtual std::unique_ptr<Result> SetKernelPacingRate(uint32_t rate_bps) = 0;
+  static constexpr uint32_t kMaxSendBuffers = 4;
 };
 
 class UdpNetworkTranceiver : public NetworkTranceiver, NetworkIOHandler {
@@ -32,6 +48,11 @@ class UdpNetworkTranceiver : public NetworkTranceiver, NetworkIOHandler {
       NetworkIoScheduler* scheduler, RtpRtcpPacketDemuxer* demuxer) override;
   virtual void Send(std::unique_ptr<DataBuffer> data_buffer,
                     bool is_bye) override;
+  virtual void Send(const NetworkSendBuffer* buffers,
+                    uint32_t nb_buffers) override;
+  // Shapes the outgoing flow of the socket with qWAVE on Windows.
+  virtual std::unique_ptr<Result> SetKernelPacingRate(
+      uint32_t rate_bps) override;
 
   /* NetworkIOHandler override */
   virtual uint32_t GetRequestedEvents() override;
@@ -50,6 +71,9 @@ class UdpNetworkTranceiver : public NetworkTranceiver, NetworkIOHandler {
   sockaddr local_address_;
   sockaddr remote_address_;
   SOCKET sockfd_;
+  HANDLE qos_handle_;
+  // 0 until the socket is added to a qos flow.
+  QOS_FLOWID qos_flow_id_;
 #endif
 };
 }  // namespace qosrtp
\ No newline at end of file
@@ -26,11 +26,11 @@ class App : public RtcpPacket {
   virtual ~App() override;
 
   // Parse assumes header is already parsed and validated.
-  std::unique_ptr<Result> StorePacket(const CommonHeader& packet);
+  Status StorePacket(const CommonHeader& packet);
 
-  std::unique_ptr<Result> SetSubType(uint8_t subtype);
+  Status SetSubType(uint8_t subtype);
   void SetName(uint32_t name) { name_ = name; }
-  std::unique_ptr<Result> SetData(const uint8_t* data, uint32_t data_length);
+  Status SetData(const uint8_t* data, uint32_t data_length);
 
   uint8_t sub_type() const { return sub_type_; }
   uint32_t name() const { return name_; }
@@ -39,7 +39,7 @@ class App : public RtcpPacket {
 
   virtual uint32_t BlockLength() const override;
 
-  virtual std::unique_ptr<Result> LoadPacket(
+  virtual Status LoadPacket(
       uint8_t* packet, uint32_t* pos, uint32_t max_length) const override;
 
   static inline constexpr uint32_t NameToInt(const char name[5]) {
@@ -1,6 +1,6 @@
 #include "bye.h"
 
-#include <sstream>
+#include <cstring>
 
 #include "../utils/byte_io.h"
 
@@ -11,20 +11,20 @@ Bye::Bye() = default;
 
 Bye::~Bye() = default;
 
-std::unique_ptr<Result> Bye::SetReason(std::string reason) {
+Status Bye::SetReason(std::string reason) {
   if (reason.size() > 0xffu) {
-    return Result::Create(-1, "The length of reason must be less than 0xffu.");
+    return Status::Error("The length of reason must be less than 0xffu.");
   }
   reason_ = std::string(reason);
-  return Result::Create();
+  return Status::Ok();
 }
 
-std::unique_ptr<Result> Bye::SetCsrcs(std::vector<uint32_t> csrcs) {
+Status Bye::SetCsrcs(std::vector<uint32_t> csrcs) {
   if (csrcs.size() > kMaxNumberOfCsrcs) {
-    return Result::Create(-1, "Too many CSRCs for Bye packet.");
+    return Status::Error("Too many CSRCs for Bye packet.");
   }
   csrcs_ = std::move(csrcs);
-  return Result::Create();
+  return Status::Ok();
 }
 
 uint32_t Bye::BlockLength() const {
@@ -34,13 +34,13 @@ uint32_t Bye::BlockLength() const {
   return kHeaderLength + 4 * (src_count + reason_size_in_32bits);
 }
 
-std::unique_ptr<Result> Bye::LoadPacket(uint8_t* packet, uint32_t* pos,
-                                        uint32_t max_length) const {
+Status Bye::LoadPacket(uint8_t* packet, uint32_t* pos,
+                       uint32_t max_length) const {
   /*TODO Need review!*/
   if (*pos + BlockLength() > max_length) {
-    return Result::Create(-1,
-                          "The remaining buffer space is less than the length "
-                          "of the loaded packet");
+    return Status::Error(
+        "The remaining buffer space is less than the length "
+        "of the loaded packet");
   }
   const size_t index_end = *pos + BlockLength();
   CreateHeader(1 + csrcs_.size(), kPacketType,
@@ -65,18 +65,18 @@ std::unique_ptr<Result> Bye::LoadPacket(uint8_t* packet, uint32_t* pos,
       *pos += bytes_to_pad;
     }
   }
-  return Result::Create();
+  return Status::Ok();
 }
 
-std::unique_ptr<Result> Bye::StorePacket(const CommonHeader& packet) {
+Status Bye::StorePacket(const CommonHeader& packet) {
   if (kPacketType != packet.type()) {
-    return Result::Create(-1, "The type of rtcp is not app.");
+    return Status::Error("The type of rtcp is not app.");
   }
   const uint8_t src_count = packet.count();
   // Validate packet.
   if (packet.payload_size_bytes() < 4u * src_count) {
-    return Result::Create(
-        -1, "Packet is too small to contain CSRCs it promise to have.");
+    return Status::Error(
+        "Packet is too small to contain CSRCs it promise to have.");
   }
   const uint8_t* const payload = packet.payload();
   bool has_reason = packet.payload_size_bytes() > 4u * src_count;
@@ -84,7 +84,7 @@ std::unique_ptr<Result> Bye::StorePacket(const CommonHeader& packet) {
   if (has_reason) {
     reason_length = payload[4u * src_count];
     if (packet.payload_size_bytes() - 4u * src_count < 1u + reason_length) {
-      return Result::Create(-1, "Invalid reason length.");
+      return Status::Error("Invalid reason length.");
     }
   }
   // Once sure packet is valid, copy values.
@@ -104,5 +104,5 @@ std::unique_ptr<Result> Bye::StorePacket(const CommonHeader& packet) {
   } else {
     reason_.clear();
   }
-  return Result::Create();
+  return Status::Ok();
 }
\ No newline at end of file
@@ -28,17 +28,17 @@ class Bye : public RtcpPacket {
   virtual ~Bye() override;
 
   // Parse assumes header is already parsed and validated.
-  std::unique_ptr<Result> StorePacket(const CommonHeader& packet);
+  Status StorePacket(const CommonHeader& packet);
 
-  std::unique_ptr<Result> SetCsrcs(std::vector<uint32_t> csrcs);
-  std::unique_ptr<Result> SetReason(std::string reason);
+  Status SetCsrcs(std::vector<uint32_t> csrcs);
+  Status SetReason(std::string reason);
 
   const std::vector<uint32_t>& csrcs() const { return csrcs_; }
   const std::string& reason() const { return reason_; }
 
   virtual uint32_t BlockLength() const override;
 
-  virtual std::unique_ptr<Result> LoadPacket(
+  virtual Status LoadPacket(
       uint8_t* packet, uint32_t* pos, uint32_t max_length) const override;
 
  private:
@@ -1,7 +1,7 @@
 #pragma once
 #include <memory>
 
-#include "../include/result.h"
+#include "../utils/status.h"
 
 namespace qosrtp {
 namespace rtcp {
@@ -14,8 +14,8 @@ class CommonHeader {
   CommonHeader(const CommonHeader&);
   CommonHeader& operator=(const CommonHeader&);
 
-  std::unique_ptr<Result> StorePacket(const uint8_t* buffer,
-                                      uint32_t size_bytes);
+  Status StorePacket(const uint8_t* buffer,
+                     uint32_t size_bytes);
 
   uint8_t type() const { return packet_type_; }
   // Depending on packet type same header field can be used either as count or
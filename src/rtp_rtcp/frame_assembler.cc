@@ -0,0 +1,109 @@
+#include "frame_assembler.h"
+
+#include "../utils/seq_comparison.h"
+#include "./h26x_depacketizer.h"
+
+namespace qosrtp {
+RtpFrame::RtpFrame() = default;
+
+RtpFrame::~RtpFrame() = default;
+
+RtpFrameImpl::RtpFrameImpl(uint32_t timestamp)
+    : timestamp_(timestamp), missing_(false) {}
+
+RtpFrameImpl::~RtpFrameImpl() {
+  if ((nullptr != bitstream_) && (nullptr != bitstream_pool_)) {
+    bitstream_pool_->Release(std::move(bitstream_));
+  }
+}
+
+void RtpFrameImpl::SetBitstream(std::unique_ptr<DataBuffer> bitstream,
+                                std::shared_ptr<DataBufferPool> pool) {
+  bitstream_ = std::move(bitstream);
+  bitstream_pool_ = std::move(pool);
+}
+
+const RtpPacket* RtpFrameImpl::packet(uint32_t index) const {
+  if (index >= packets_.size()) return nullptr;
+  return packets_[index].get();
+}
+
+std::vector<std::unique_ptr<RtpPacket>> RtpFrameImpl::TakePackets() {
+  return std::move(packets_);
+}
+
+FrameAssembler::FrameAssembler(RtpVideoCodec codec)
+    : depacketizer_((RtpVideoCodec::kNone != codec)
+                        ? std::make_unique<H26xDepacketizer>(codec)
+                        : nullptr),
+      frame_(nullptr),
+      frame_missing_(false),
+      last_packet_utc_ms_(0),
+      has_last_seq_(false),
+      last_seq_(0),
+      has_finished_timestamp_(false),
+      finished_timestamp_(0) {}
+
+FrameAssembler::~FrameAssembler() = default;
+
+void FrameAssembler::InsertPackets(
+    std::vector<std::unique_ptr<RtpPacket>> packets, uint64_t utc_ms_now,
+    std::vector<std::unique_ptr<RtpFrame>>& frames) {
+  for (auto& packet : packets) {
+    uint16_t seq = packet->sequence_number();
+    bool continuous = !has_last_seq_ || IsNextSeq(last_seq_, seq);
+    if ((nullptr == frame_) && has_finished_timestamp_ &&
+        (finished_timestamp_ == packet->timestamp())) {
+      // Not a frame start, its frame was delivered already. Its seq still
+      // counts, the next frame follows it.
+      has_last_seq_ = true;
+      last_seq_ = seq;
+      continue;
+    }
+    if ((nullptr != frame_) && (frame_->timestamp() != packet->timestamp())) {
+      FinishFrame(frame_missing_ || !continuous, frames);
+    }
+    if (nullptr == frame_) {
+      frame_ = std::make_unique<RtpFrameImpl>(packet->timestamp());
+      frame_missing_ = !continuous;
+    } else if (!continuous) {
+      frame_missing_ = true;
+    }
+    bool marker = packet->m();
+    frame_->AddPacket(std::move(packet));
+    has_last_seq_ = true;
+    last_seq_ = seq;
+    last_packet_utc_ms_ = utc_ms_now;
+    if (marker) {
+      FinishFrame(frame_missing_, frames);
+    }
+  }
+}
+
+void FrameAssembler::Flush(uint64_t utc_ms_now, uint16_t timeout_ms,
+                           std::vector<std::unique_ptr<RtpFrame>>& frames) {
+  if (nullptr == frame_) return;
+  if (utc_ms_now - last_packet_utc_ms_ < timeout_ms) return;
+  FinishFrame(true, frames);
+}
+
+bool FrameAssembler::GetFlushTime(uint16_t timeout_ms,
+                                  uint64_t& flush_time_utc_ms) const {
+  if (nullptr == frame_) return false;
+  flush_time_utc_ms = last_packet_utc_ms_ + timeout_ms;
+  return true;
+}
+
+void FrameAssembler::FinishFrame(
+    bool missing, std::vector<std::unique_ptr<RtpFrame>>& frames) {
+  frame_->SetMissing(missing);
+  has_finished_timestamp_ = true;
+  finished_timestamp_ = frame_->timestamp();
+  if (!missing && (nullptr != depacketizer_)) {
+    depacketizer_->Depacketize(*frame_);
+  }
+  frames.push_back(std::move(frame_));
+  frame_ = nullptr;
+  frame_missing_ = false;
+}
+}  // namespace qosrtp
\ No newline at end of file
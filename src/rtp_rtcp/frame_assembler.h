@@ -0,0 +1,80 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "../include/rtp_frame.h"
+#include "../utils/data_buffer_pool.h"
+
+namespace qosrtp {
+class RtpFrameImpl final : public RtpFrame {
+ public:
+  RtpFrameImpl(uint32_t timestamp);
+  // Hands the bitstream back to its pool.
+  virtual ~RtpFrameImpl() override;
+  virtual uint32_t timestamp() const override { return timestamp_; }
+  virtual bool missing() const override { return missing_; }
+  virtual uint32_t nb_packets() const override {
+    return static_cast<uint32_t>(packets_.size());
+  }
+  virtual const RtpPacket* packet(uint32_t index) const override;
+  virtual const DataBuffer* bitstream() const override {
+    return bitstream_.get();
+  }
+  virtual std::vector<std::unique_ptr<RtpPacket>> TakePackets() override;
+  void AddPacket(std::unique_ptr<RtpPacket> packet) {
+    packets_.push_back(std::move(packet));
+  }
+  void SetMissing(bool missing) { missing_ = missing; }
+  void SetBitstream(std::unique_ptr<DataBuffer> bitstream,
+                    std::shared_ptr<DataBufferPool> pool);
+
+ private:
+  uint32_t timestamp_;
+  bool missing_;
+  std::vector<std::unique_ptr<RtpPacket>> packets_;
+  std::unique_ptr<DataBuffer> bitstream_;
+  // Shared since the frame may outlive the receiver that made it.
+  std::shared_ptr<DataBufferPool> bitstream_pool_;
+};
+
+class H26xDepacketizer;
+
+// Groups the packets released by the receive cache into frames. A frame ends
+// at its marker bit, or at the first packet of the next timestamp for
+// payloads that do not set the marker. It is complete if its first packet
+// directly follows the previous frame, its seqs are continuous and its end
+// is followed directly by the next frame or marked. The cache only skips a
+// seq once the seq's deadline has passed, so a frame with a gap is final.
+// Packets of the frame delivered last, e.g. a late marker packet of a
+// flushed frame, are dropped rather than started as a frame of their own.
+class FrameAssembler {
+ public:
+  // With a video codec, the bitstream of every complete frame is built.
+  explicit FrameAssembler(RtpVideoCodec codec);
+  ~FrameAssembler();
+  // The seq of the packets "increases" with index.
+  void InsertPackets(std::vector<std::unique_ptr<RtpPacket>> packets,
+                     uint64_t utc_ms_now,
+                     std::vector<std::unique_ptr<RtpFrame>>& frames);
+  // Delivers the pending frame as missing if no packet was added to it for
+  // timeout_ms, e.g. when the packet with its marker bit was lost and the
+  // stream paused.
+  void Flush(uint64_t utc_ms_now, uint16_t timeout_ms,
+             std::vector<std::unique_ptr<RtpFrame>>& frames);
+  // Time at which Flush will deliver the pending frame, false if there is no
+  // pending frame.
+  bool GetFlushTime(uint16_t timeout_ms, uint64_t& flush_time_utc_ms) const;
+
+ private:
+  void FinishFrame(bool missing,
+                   std::vector<std::unique_ptr<RtpFrame>>& frames);
+  std::unique_ptr<H26xDepacketizer> depacketizer_;
+  std::unique_ptr<RtpFrameImpl> frame_;
+  bool frame_missing_;
+  uint64_t last_packet_utc_ms_;
+  bool has_last_seq_;
+  uint16_t last_seq_;
+  bool has_finished_timestamp_;
+  uint32_t finished_timestamp_;
+};
+}  // namespace qosrtp
\ No newline at end of file
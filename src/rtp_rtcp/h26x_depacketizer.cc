@@ -0,0 +1,184 @@
+#include "h26x_depacketizer.h"
+
+#include <cstring>
+
+#include "../include/log.h"
+#include "../utils/byte_io.h"
+
+namespace qosrtp {
+namespace {
+constexpr uint8_t kH264TypeMask = 0x1F;
+constexpr uint8_t kH264StapA = 24;
+constexpr uint8_t kH264FuA = 28;
+constexpr uint8_t kH264Idr = 5;
+constexpr uint8_t kH264Sps = 7;
+constexpr uint8_t kH265PayloadHeaderSize = 2;
+constexpr uint8_t kH265Ap = 48;
+constexpr uint8_t kH265Fu = 49;
+constexpr uint8_t kH265IrapFirst = 16;
+constexpr uint8_t kH265IrapLast = 21;
+constexpr uint8_t kH265Vps = 32;
+constexpr uint8_t kH265Sps = 33;
+constexpr uint8_t kFuStartBit = 0x80;
+constexpr uint8_t kFuEndBit = 0x40;
+}  // namespace
+
+H26xDepacketizer::H26xDepacketizer(RtpVideoCodec codec)
+    : codec_(codec),
+      pool_(std::make_shared<DataBufferPool>(kNbPreallocatedBuffers,
+                                             kPreallocatedBufferSize)),
+      in_fragment_(false) {}
+
+H26xDepacketizer::~H26xDepacketizer() = default;
+
+void H26xDepacketizer::Write(const uint8_t* data, uint32_t size,
+                             uint8_t* output, uint32_t& pos) {
+  if (nullptr != output) {
+    memcpy(output + pos, data, size);
+  }
+  pos += size;
+}
+
+bool H26xDepacketizer::Depacketize(RtpFrameImpl& frame) {
+  uint32_t size = 0;
+  if (!ParsePackets(frame, nullptr, size) || (0 == size)) {
+    QOSRTP_LOG(Warning, "Failed to depacketize frame, timestamp: %u",
+               frame.timestamp());
+    return false;
+  }
+  std::unique_ptr<DataBuffer> bitstream = pool_->Acquire(size);
+  bitstream->SetSize(size);
+  uint32_t pos = 0;
+  // Cannot fail, the payloads passed the first pass.
+  ParsePackets(frame, bitstream->GetW(), pos);
+  frame.SetBitstream(std::move(bitstream), pool_);
+  return true;
+}
+
+bool H26xDepacketizer::IsKeyFrameStart(RtpVideoCodec codec,
+                                       const uint8_t* payload,
+                                       uint32_t size) {
+  if (RtpVideoCodec::kH264 == codec) {
+    if (size < 2) return false;
+    uint8_t type = payload[0] & kH264TypeMask;
+    if (kH264StapA == type) {
+      // The first NAL unit follows the STAP-A header and its size.
+      if (size < 4) return false;
+      type = payload[3] & kH264TypeMask;
+    } else if (kH264FuA == type) {
+      if (!(payload[1] & kFuStartBit)) return false;
+      type = payload[1] & kH264TypeMask;
+    }
+    return (kH264Idr == type) || (kH264Sps == type);
+  }
+  if (RtpVideoCodec::kH265 == codec) {
+    if (size <= kH265PayloadHeaderSize) return false;
+    uint8_t type = (payload[0] >> 1) & 0x3F;
+    if (kH265Ap == type) {
+      if (size < kH265PayloadHeaderSize + 3) return false;
+      type = (payload[kH265PayloadHeaderSize + 2] >> 1) & 0x3F;
+    } else if (kH265Fu == type) {
+      uint8_t fu_header = payload[kH265PayloadHeaderSize];
+      if (!(fu_header & kFuStartBit)) return false;
+      type = fu_header & 0x3F;
+    }
+    return ((type >= kH265IrapFirst) && (type <= kH265IrapLast)) ||
+           (kH265Vps == type) || (kH265Sps == type);
+  }
+  return false;
+}
+
+bool H26xDepacketizer::ParsePackets(const RtpFrameImpl& frame,
+                                    uint8_t* output, uint32_t& pos) {
+  in_fragment_ = false;
+  for (uint32_t i = 0; i < frame.nb_packets(); ++i) {
+    const DataBuffer* payload = frame.packet(i)->GetPayloadBuffer();
+    if ((nullptr == payload) || (0 == payload->size())) return false;
+    bool ok = (RtpVideoCodec::kH264 == codec_)
+                  ? ParseH264(payload->Get(), payload->size(), output, pos)
+                  : ParseH265(payload->Get(), payload->size(), output, pos);
+    if (!ok) return false;
+  }
+  return !in_fragment_;
+}
+
+bool H26xDepacketizer::ParseAggregation(const uint8_t* payload, uint32_t size,
+                                        uint32_t offset, uint8_t* output,
+                                        uint32_t& pos) {
+  if (offset >= size) return false;
+  while (offset < size) {
+    if (offset + sizeof(uint16_t) > size) return false;
+    uint16_t nal_size = ByteReader<uint16_t>::ReadBigEndian(payload + offset);
+    offset += sizeof(uint16_t);
+    if ((0 == nal_size) || (offset + nal_size > size)) return false;
+    Write(kStartCode, sizeof(kStartCode), output, pos);
+    Write(payload + offset, nal_size, output, pos);
+    offset += nal_size;
+  }
+  return true;
+}
+
+bool H26xDepacketizer::ParseH264(const uint8_t* payload, uint32_t size,
+                                 uint8_t* output, uint32_t& pos) {
+  uint8_t type = payload[0] & kH264TypeMask;
+  if (kH264FuA == type) {
+    if (size <= 2) return false;
+    uint8_t fu_header = payload[1];
+    if (fu_header & kFuStartBit) {
+      if (in_fragment_) return false;
+      uint8_t nal_header = (payload[0] & ~kH264TypeMask) |
+                           (fu_header & kH264TypeMask);
+      Write(kStartCode, sizeof(kStartCode), output, pos);
+      Write(&nal_header, 1, output, pos);
+      in_fragment_ = true;
+    } else if (!in_fragment_) {
+      return false;
+    }
+    Write(payload + 2, size - 2, output, pos);
+    if (fu_header & kFuEndBit) in_fragment_ = false;
+    return true;
+  }
+  if (in_fragment_) return false;
+  if (kH264StapA == type) {
+    return ParseAggregation(payload, size, 1, output, pos);
+  }
+  if ((0 == type) || (type > 23)) return false;
+  Write(kStartCode, sizeof(kStartCode), output, pos);
+  Write(payload, size, output, pos);
+  return true;
+}
+
+bool H26xDepacketizer::ParseH265(const uint8_t* payload, uint32_t size,
+                                 uint8_t* output, uint32_t& pos) {
+  if (size <= kH265PayloadHeaderSize) return false;
+  uint8_t type = (payload[0] >> 1) & 0x3F;
+  if (kH265Fu == type) {
+    if (size <= kH265PayloadHeaderSize + 1) return false;
+    uint8_t fu_header = payload[kH265PayloadHeaderSize];
+    if (fu_header & kFuStartBit) {
+      if (in_fragment_) return false;
+      uint8_t nal_header[2] = {
+          static_cast<uint8_t>((payload[0] & 0x81) | ((fu_header & 0x3F) << 1)),
+          payload[1]};
+      Write(kStartCode, sizeof(kStartCode), output, pos);
+      Write(nal_header, sizeof(nal_header), output, pos);
+      in_fragment_ = true;
+    } else if (!in_fragment_) {
+      return false;
+    }
+    Write(payload + kH265PayloadHeaderSize + 1,
+          size - kH265PayloadHeaderSize - 1, output, pos);
+    if (fu_header & kFuEndBit) in_fragment_ = false;
+    return true;
+  }
+  if (in_fragment_) return false;
+  if (kH265Ap == type) {
+    return ParseAggregation(payload, size, kH265PayloadHeaderSize, output,
+                            pos);
+  }
+  if (type > kH265Ap) return false;
+  Write(kStartCode, sizeof(kStartCode), output, pos);
+  Write(payload, size, output, pos);
+  return true;
+}
+}  // namespace qosrtp
\ No newline at end of file
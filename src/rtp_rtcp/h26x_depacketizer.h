@@ -0,0 +1,49 @@
+#pragma once
+#include <memory>
+
+#include "../include/rtp_frame.h"
+#include "../utils/data_buffer_pool.h"
+#include "./frame_assembler.h"
+
+namespace qosrtp {
+// Turns the rtp payloads of an H.264 or H.265 frame into one Annex-B byte
+// stream. A first pass over the payloads only counts the bytes, so the
+// output buffer is taken from a pool with the exact size needed and every
+// NAL unit byte is then copied once, straight from the packet payload.
+class H26xDepacketizer {
+ public:
+  explicit H26xDepacketizer(RtpVideoCodec codec);
+  ~H26xDepacketizer();
+  // Returns false and leaves the frame without bitstream if a payload is
+  // malformed, uses an unsupported packetization or a fragmented NAL unit is
+  // cut.
+  bool Depacketize(RtpFrameImpl& frame);
+  // True if the payload starts a key frame, an IDR or SPS NAL unit for
+  // H.264 and an IRAP, VPS or SPS NAL unit for H.265, alone, first in an
+  // aggregation packet or in the first fragment.
+  static bool IsKeyFrameStart(RtpVideoCodec codec, const uint8_t* payload,
+                              uint32_t size);
+
+ private:
+  static constexpr uint32_t kNbPreallocatedBuffers = 2;
+  static constexpr uint32_t kPreallocatedBufferSize = 64 * 1024;
+  static constexpr uint8_t kStartCode[4] = {0x00, 0x00, 0x00, 0x01};
+  // Walks the NAL units of one payload and appends them at pos. With a
+  // nullptr output nothing is written and only pos advances.
+  bool ParseH264(const uint8_t* payload, uint32_t size, uint8_t* output,
+                 uint32_t& pos);
+  bool ParseH265(const uint8_t* payload, uint32_t size, uint8_t* output,
+                 uint32_t& pos);
+  // Aggregation packets, STAP-A and AP, from offset on.
+  bool ParseAggregation(const uint8_t* payload, uint32_t size,
+                        uint32_t offset, uint8_t* output, uint32_t& pos);
+  bool ParsePackets(const RtpFrameImpl& frame, uint8_t* output,
+                    uint32_t& pos);
+  static void Write(const uint8_t* data, uint32_t size, uint8_t* output,
+                    uint32_t& pos);
+  const RtpVideoCodec codec_;
+  std::shared_ptr<DataBufferPool> pool_;
+  // True inside a fragmented NAL unit.
+  bool in_fragment_;
+};
+}  // namespace qosrtp
\ No newline at end of file
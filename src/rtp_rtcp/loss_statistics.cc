@@ -0,0 +1,162 @@
+#include "loss_statistics.h"
+
+#include <algorithm>
+
+namespace qosrtp {
+LossStatistics::LossStatistics()
+    : has_packet_(false),
+      highest_seq_(0),
+      next_final_seq_(0),
+      received_(kWindowSize / 64, 0),
+      received_original_(kWindowSize / 64, 0),
+      run_lost_(false),
+      run_length_(0),
+      candidate_packets_(0),
+      candidate_losses_(0),
+      received_since_loss_(0),
+      gap_packets_(0),
+      gap_losses_(0),
+      burst_packets_(0),
+      burst_losses_(0),
+      nb_bursts_(0) {}
+
+LossStatistics::~LossStatistics() = default;
+
+uint32_t LossStatistics::Log2Bucket(uint64_t value) {
+  uint32_t bucket = 0;
+  while ((value > 1) && (bucket < LossPatternStatistics::kNbBuckets - 1)) {
+    value >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+bool LossStatistics::GetBit(const std::vector<uint64_t>& bits,
+                            int64_t unwrapped_seq) const {
+  uint32_t slot = static_cast<uint32_t>(unwrapped_seq) & (kWindowSize - 1);
+  return (bits[slot >> 6] >> (slot & 63)) & 1;
+}
+
+void LossStatistics::SetBit(std::vector<uint64_t>& bits,
+                            int64_t unwrapped_seq) {
+  uint32_t slot = static_cast<uint32_t>(unwrapped_seq) & (kWindowSize - 1);
+  bits[slot >> 6] |= (uint64_t(1) << (slot & 63));
+}
+
+void LossStatistics::ClearBits(int64_t from, int64_t to) {
+  if (to - from >= kWindowSize) {
+    std::fill(received_.begin(), received_.end(), 0);
+    std::fill(received_original_.begin(), received_original_.end(), 0);
+    return;
+  }
+  for (int64_t seq = from + 1; seq <= to; ++seq) {
+    uint32_t slot = static_cast<uint32_t>(seq) & (kWindowSize - 1);
+    uint64_t mask = ~(uint64_t(1) << (slot & 63));
+    received_[slot >> 6] &= mask;
+    received_original_[slot >> 6] &= mask;
+  }
+}
+
+void LossStatistics::OnPacket(int64_t unwrapped_seq, bool retransmitted,
+                              bool after_deadline) {
+  if (!has_packet_) {
+    has_packet_ = true;
+    highest_seq_ = unwrapped_seq;
+    next_final_seq_ = unwrapped_seq;
+  } else if (unwrapped_seq > highest_seq_) {
+    // The seqs above the old highest one were not received and their slots
+    // still hold older seqs, so finalize before clearing.
+    FinalizeUpTo(unwrapped_seq - kSettleDistance);
+    ClearBits(highest_seq_, unwrapped_seq);
+    highest_seq_ = unwrapped_seq;
+  } else if (highest_seq_ - unwrapped_seq < kWindowSize) {
+    if (GetBit(received_, unwrapped_seq)) {
+      ++statistics_.duplicates;
+      return;
+    }
+  }
+  // Retransmissions are late by a nack round trip, not reordered.
+  if (!retransmitted && (unwrapped_seq < highest_seq_)) {
+    uint64_t reorder_depth = highest_seq_ - unwrapped_seq;
+    ++statistics_.reorder_depths[Log2Bucket(reorder_depth)];
+    statistics_.max_reorder_depth = static_cast<uint32_t>(std::min<uint64_t>(
+        std::max<uint64_t>(statistics_.max_reorder_depth, reorder_depth),
+        UINT32_MAX));
+  }
+  if (after_deadline) {
+    ++statistics_.late_arrivals;
+  }
+  if ((unwrapped_seq < next_final_seq_) ||
+      (highest_seq_ - unwrapped_seq >= kWindowSize)) {
+    return;
+  }
+  SetBit(received_, unwrapped_seq);
+  if (!retransmitted) {
+    SetBit(received_original_, unwrapped_seq);
+  }
+}
+
+void LossStatistics::FinalizeUpTo(int64_t unwrapped_seq) {
+  for (; next_final_seq_ <= unwrapped_seq; ++next_final_seq_) {
+    OnFinalized((next_final_seq_ > highest_seq_) ||
+                !GetBit(received_original_, next_final_seq_));
+  }
+}
+
+void LossStatistics::OnFinalized(bool lost) {
+  if ((run_length_ > 0) && (lost != run_lost_)) {
+    if (run_lost_) {
+      ++statistics_.burst_lengths[std::min(
+          run_length_, LossPatternStatistics::kNbBuckets) - 1];
+    } else {
+      ++statistics_.gap_lengths[Log2Bucket(run_length_)];
+    }
+    run_length_ = 0;
+  }
+  run_lost_ = lost;
+  ++run_length_;
+  if (lost) {
+    if (0 == candidate_losses_) {
+      candidate_packets_ = 1;
+    } else {
+      candidate_packets_ += received_since_loss_ + 1;
+    }
+    ++candidate_losses_;
+    received_since_loss_ = 0;
+    return;
+  }
+  if (0 == candidate_losses_) {
+    ++gap_packets_;
+    return;
+  }
+  if (++received_since_loss_ < kMinGapLength) return;
+  // The candidate is over, one loss on its own belongs to the gap.
+  if (candidate_losses_ >= 2) {
+    burst_packets_ += candidate_packets_;
+    burst_losses_ += candidate_losses_;
+    ++nb_bursts_;
+  } else {
+    gap_packets_ += candidate_packets_;
+    gap_losses_ += candidate_losses_;
+  }
+  gap_packets_ += received_since_loss_;
+  candidate_packets_ = 0;
+  candidate_losses_ = 0;
+  received_since_loss_ = 0;
+}
+
+const LossPatternStatistics& LossStatistics::statistics() {
+  statistics_.gap_to_burst_probability =
+      (0 == gap_packets_) ? 0 : static_cast<double>(nb_bursts_) / gap_packets_;
+  statistics_.burst_to_gap_probability =
+      (0 == burst_packets_) ? 0
+                            : static_cast<double>(nb_bursts_) / burst_packets_;
+  statistics_.gap_loss_density =
+      (0 == gap_packets_) ? 0 : static_cast<double>(gap_losses_) / gap_packets_;
+  statistics_.burst_loss_density =
+      (0 == burst_packets_)
+          ? 0
+          : static_cast<double>(burst_losses_) / burst_packets_;
+  return statistics_;
+}
+}  // namespace qosrtp
\ No newline at end of file
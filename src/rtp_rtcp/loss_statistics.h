@@ -0,0 +1,78 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace qosrtp {
+struct LossPatternStatistics {
+  static constexpr uint32_t kNbBuckets = 16;
+  // burst_lengths[i] counts runs of i + 1 lost packets, the last bucket also
+  // the longer runs.
+  std::array<uint32_t, kNbBuckets> burst_lengths = {};
+  // gap_lengths[i] counts runs of [2^i, 2^(i+1)) received packets.
+  std::array<uint32_t, kNbBuckets> gap_lengths = {};
+  // reorder_depths[i] counts packets that arrived [2^i, 2^(i+1)) seqs after
+  // a higher seq.
+  std::array<uint32_t, kNbBuckets> reorder_depths = {};
+  uint32_t max_reorder_depth = 0;
+  uint32_t duplicates = 0;
+  // Packets that arrived after the receiver stopped waiting for them.
+  uint32_t late_arrivals = 0;
+  // Gilbert-Elliott model as in RFC 3611 4.7.2. A burst is a run of packets
+  // from a loss to a loss without kMinGapLength received packets in between,
+  // with at least two losses. Everything else, isolated losses included, is
+  // the gap state.
+  double gap_to_burst_probability = 0;
+  double burst_to_gap_probability = 0;
+  double gap_loss_density = 0;
+  double burst_loss_density = 0;
+};
+
+// Loss pattern of one rtp stream, updated on every packet. A seq is final
+// once kSettleDistance higher seqs were received, it then counts as lost if
+// its original packet never arrived, even if a retransmission did, because
+// that is what the network did to the stream.
+class LossStatistics {
+ public:
+  // gmin of RFC 3611.
+  static constexpr uint32_t kMinGapLength = 16;
+  LossStatistics();
+  ~LossStatistics();
+  // after_deadline is true if the packet is too old to be used.
+  void OnPacket(int64_t unwrapped_seq, bool retransmitted, bool after_deadline);
+  const LossPatternStatistics& statistics();
+
+ private:
+  // Must be a power of two and larger than kSettleDistance.
+  static constexpr uint32_t kWindowSize = 1024;
+  static constexpr uint32_t kSettleDistance = 64;
+  static uint32_t Log2Bucket(uint64_t value);
+  bool GetBit(const std::vector<uint64_t>& bits, int64_t unwrapped_seq) const;
+  void SetBit(std::vector<uint64_t>& bits, int64_t unwrapped_seq);
+  // Clears the bits of (from, to], the slots are about to be reused.
+  void ClearBits(int64_t from, int64_t to);
+  // Finalizes the seqs up to and including unwrapped_seq.
+  void FinalizeUpTo(int64_t unwrapped_seq);
+  void OnFinalized(bool lost);
+  LossPatternStatistics statistics_;
+  bool has_packet_;
+  int64_t highest_seq_;
+  int64_t next_final_seq_;
+  // One bit per seq for seqs after highest_seq_ - kWindowSize.
+  std::vector<uint64_t> received_;
+  std::vector<uint64_t> received_original_;
+  // Current run of final seqs.
+  bool run_lost_;
+  uint32_t run_length_;
+  // Candidate burst of the Gilbert-Elliott model, from its first to its last
+  // loss, and the packets received since its last loss.
+  uint32_t candidate_packets_;
+  uint32_t candidate_losses_;
+  uint32_t received_since_loss_;
+  uint64_t gap_packets_;
+  uint64_t gap_losses_;
+  uint64_t burst_packets_;
+  uint64_t burst_losses_;
+  uint32_t nb_bursts_;
+};
+}  // namespace qosrtp
\ No newline at end of file
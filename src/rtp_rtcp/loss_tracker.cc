@@ -0,0 +1,191 @@
+#include "loss_tracker.h"
+
+#include <intrin.h>
+
+#include <algorithm>
+
+#include "../utils/time_utils.h"
+
+namespace qosrtp {
+LossTracker::LossTracker(uint32_t capacity)
+    : capacity_(capacity),
+      mask_(capacity - 1),
+      missing_(capacity / 64, 0),
+      nack_states_(capacity),
+      time_base_utc_ms_(UTCTimeMillis()),
+      nack_interval_ms_(kDefaultRttMs + kMinNackMarginMs),
+      rtt_ms_(0),
+      nb_suppressed_nacks_(0),
+      nb_nacked_seqs_(0),
+      nb_spurious_nacks_(0),
+      reorder_distances_(),
+      reorder_delays_(),
+      nb_reorder_samples_(0),
+      reorder_wait_packets_(1),
+      reorder_wait_ms_(0),
+      begin_seq_(0),
+      end_seq_(0) {}
+
+LossTracker::~LossTracker() = default;
+
+bool LossTracker::IsMissing(int64_t unwrapped_seq) const {
+  if ((unwrapped_seq < begin_seq_) || (unwrapped_seq >= end_seq_)) {
+    return false;
+  }
+  uint32_t slot = static_cast<uint32_t>(unwrapped_seq) & mask_;
+  return (missing_[slot >> 6] >> (slot & 63)) & 1;
+}
+
+void LossTracker::ClearRange(int64_t from, int64_t to) {
+  while (from < to) {
+    uint32_t slot = static_cast<uint32_t>(from) & mask_;
+    uint32_t bit = slot & 63;
+    int64_t nb_bits = std::min<int64_t>(64 - bit, to - from);
+    uint64_t bits = (64 == nb_bits)
+                        ? ~uint64_t(0)
+                        : (((uint64_t(1) << nb_bits) - 1) << bit);
+    missing_[slot >> 6] &= ~bits;
+    from += nb_bits;
+  }
+}
+
+void LossTracker::AddLoss(int64_t from, int64_t to, uint64_t utc_ms_now,
+                          uint64_t deadline_utc_ms) {
+  if (from > to) return;
+  if (begin_seq_ == end_seq_) {
+    begin_seq_ = from;
+    end_seq_ = from;
+  }
+  // Slide the window first, the slots of the new seqs may still hold old
+  // ones.
+  if (to + 1 - begin_seq_ > capacity_) {
+    RemoveBefore(to + 1 - capacity_);
+  }
+  end_seq_ = std::max(end_seq_, to + 1);
+  from = std::max(from, end_seq_ - capacity_);
+  begin_seq_ = std::min(begin_seq_, from);
+  uint32_t now_ms = static_cast<uint32_t>(utc_ms_now - time_base_utc_ms_);
+  uint32_t deadline_ms =
+      static_cast<uint32_t>(deadline_utc_ms - time_base_utc_ms_);
+  for (int64_t seq = from; seq <= to; ++seq) {
+    uint32_t slot = static_cast<uint32_t>(seq) & mask_;
+    missing_[slot >> 6] |= (uint64_t(1) << (slot & 63));
+    nack_states_[slot] = {now_ms, 0, deadline_ms, 0};
+  }
+}
+
+bool LossTracker::OnReceived(int64_t unwrapped_seq, int64_t reorder_distance,
+                             bool retransmitted, uint64_t utc_ms_now) {
+  if (!IsMissing(unwrapped_seq)) return false;
+  uint32_t slot = static_cast<uint32_t>(unwrapped_seq) & mask_;
+  missing_[slot >> 6] &= ~(uint64_t(1) << (slot & 63));
+  const NackState& state = nack_states_[slot];
+  if (retransmitted) return true;
+  // Originals that arrive after their nack are sampled as well, otherwise
+  // a wait too short to hold back any nack could never grow.
+  uint32_t now_ms = static_cast<uint32_t>(utc_ms_now - time_base_utc_ms_);
+  AddReorderSample(reorder_distance, now_ms - state.first_seen_ms);
+  if (0 != state.nb_sent) ++nb_spurious_nacks_;
+  return true;
+}
+
+uint32_t LossTracker::PercentileBucket(const ReorderHistogram& histogram,
+                                       uint32_t nb_samples) {
+  uint64_t threshold =
+      (static_cast<uint64_t>(nb_samples) * kReorderPercentile + 99) / 100;
+  uint64_t nb_counted = 0;
+  for (uint32_t bucket = 0; bucket < kNbReorderBuckets; ++bucket) {
+    nb_counted += histogram[bucket];
+    if (nb_counted >= threshold) return bucket;
+  }
+  return kNbReorderBuckets - 1;
+}
+
+void LossTracker::AddReorderSample(int64_t reorder_distance,
+                                   uint32_t reorder_delay_ms) {
+  if (nb_reorder_samples_ >= kMaxNbReorderSamples) {
+    nb_reorder_samples_ = 0;
+    for (uint32_t bucket = 0; bucket < kNbReorderBuckets; ++bucket) {
+      reorder_distances_[bucket] >>= 1;
+      reorder_delays_[bucket] >>= 1;
+      nb_reorder_samples_ += reorder_distances_[bucket];
+    }
+  }
+  ++reorder_distances_[std::min<int64_t>(std::max<int64_t>(reorder_distance, 0),
+                                         kNbReorderBuckets - 1)];
+  ++reorder_delays_[std::min(reorder_delay_ms / kReorderDelayBucketMs,
+                             kNbReorderBuckets - 1)];
+  ++nb_reorder_samples_;
+  // A packet reordered by d seqs is missed until d later seqs have arrived.
+  reorder_wait_packets_ =
+      PercentileBucket(reorder_distances_, nb_reorder_samples_) + 1;
+  reorder_wait_ms_ = (PercentileBucket(reorder_delays_, nb_reorder_samples_) +
+                      1) * kReorderDelayBucketMs;
+}
+
+void LossTracker::RemoveBefore(int64_t unwrapped_seq) {
+  if (unwrapped_seq <= begin_seq_) return;
+  ClearRange(begin_seq_, std::min(unwrapped_seq, end_seq_));
+  begin_seq_ = unwrapped_seq;
+  end_seq_ = std::max(end_seq_, begin_seq_);
+}
+
+void LossTracker::Remove(int64_t from, int64_t to) {
+  ClearRange(std::max(from, begin_seq_), std::min(to + 1, end_seq_));
+}
+
+void LossTracker::UpdateRtt(uint32_t rtt_ms, uint32_t jitter_ms) {
+  rtt_ms_ = rtt_ms;
+  if (0 == rtt_ms) {
+    rtt_ms = kDefaultRttMs;
+  }
+  nack_interval_ms_ =
+      std::min(rtt_ms + std::max(kMinNackMarginMs, 2 * jitter_ms),
+               kMaxNackIntervalMs);
+}
+
+void LossTracker::GetSeqsForNack(uint64_t utc_ms_now, int64_t highest_seq,
+                                 std::vector<uint16_t>& loss_packet_seqs) {
+  uint32_t now_ms = static_cast<uint32_t>(utc_ms_now - time_base_utc_ms_);
+  int64_t seq = begin_seq_;
+  while (seq < end_seq_) {
+    uint32_t slot = static_cast<uint32_t>(seq) & mask_;
+    uint64_t word = missing_[slot >> 6] >> (slot & 63);
+    if (0 == word) {
+      seq += 64 - (slot & 63);
+      continue;
+    }
+    unsigned long index = 0;
+    _BitScanForward64(&index, word);
+    seq += index;
+    if (seq >= end_seq_) break;
+    slot = static_cast<uint32_t>(seq) & mask_;
+    NackState& state = nack_states_[slot];
+    // Not missing long enough to tell it from a reordered packet.
+    if ((0 == state.nb_sent) && (highest_seq - seq < reorder_wait_packets_) &&
+        (now_ms - state.first_seen_ms < reorder_wait_ms_)) {
+      ++seq;
+      continue;
+    }
+    if ((0 == state.nb_sent) ||
+        (now_ms - state.last_sent_ms >= nack_interval_ms_)) {
+      if ((state.nb_sent >= kMaxNbNacks) ||
+          (now_ms - state.first_seen_ms > kMaxNackAgeMs)) {
+        missing_[slot >> 6] &= ~(uint64_t(1) << (slot & 63));
+      } else if ((0 != rtt_ms_) &&
+                 (static_cast<int64_t>(state.deadline_ms) - now_ms <
+                  static_cast<int64_t>(rtt_ms_))) {
+        // The deadline only gets closer, a later nack would not help either.
+        missing_[slot >> 6] &= ~(uint64_t(1) << (slot & 63));
+        ++nb_suppressed_nacks_;
+      } else {
+        if (0 == state.nb_sent) ++nb_nacked_seqs_;
+        state.last_sent_ms = now_ms;
+        ++state.nb_sent;
+        loss_packet_seqs.push_back(static_cast<uint16_t>(seq));
+      }
+    }
+    ++seq;
+  }
+}
+}  // namespace qosrtp
\ No newline at end of file
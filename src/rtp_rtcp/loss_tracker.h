@@ -0,0 +1,107 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace qosrtp {
+// Missing seqs of one rtp stream, keyed by unwrapped seq. One bit per seq in
+// a sliding window marks it as missing and the nack state of the seq sits in
+// an array indexed the same way, so gap detection and building the nack list
+// work on 64 seqs per word and never allocate.
+// A gap is not nacked right away. Missing seqs whose original packet
+// arrives, nacked or not, were only reordered, their reorder distance and
+// delay feed two histograms, and a seq is nacked once it is missing for
+// longer than most reordered packets were.
+class LossTracker {
+ public:
+  // capacity must be a power of two and a multiple of 64. It bounds the
+  // distance between the oldest and the newest tracked seq.
+  explicit LossTracker(uint32_t capacity);
+  ~LossTracker();
+  // Marks [from, to] as missing. If the window gets larger than capacity,
+  // the oldest seqs are no longer tracked. deadline_utc_ms is when the
+  // receiver stops waiting for the seqs.
+  void AddLoss(int64_t from, int64_t to, uint64_t utc_ms_now,
+               uint64_t deadline_utc_ms);
+  // Returns true if unwrapped_seq was missing. reorder_distance is the
+  // number of seqs received after unwrapped_seq.
+  bool OnReceived(int64_t unwrapped_seq, int64_t reorder_distance,
+                  bool retransmitted, uint64_t utc_ms_now);
+  // Stops tracking the seqs before unwrapped_seq.
+  void RemoveBefore(int64_t unwrapped_seq);
+  // Stops tracking the seqs in [from, to].
+  void Remove(int64_t from, int64_t to);
+  // The retransmission of a nack is expected after rtt_ms plus a margin for
+  // jitter_ms, a seq is nacked again only when that time has passed. 0 for
+  // rtt_ms means the rtt is unknown.
+  void UpdateRtt(uint32_t rtt_ms, uint32_t jitter_ms);
+  // seq in loss_packet_seqs "increases" with index. A seq is given up once it
+  // has been nacked kMaxNbNacks times or is older than kMaxNackAgeMs. Once
+  // the rtt is known, a seq whose retransmission cannot arrive before its
+  // deadline is given up without a nack. highest_seq is the highest seq
+  // received so far.
+  void GetSeqsForNack(uint64_t utc_ms_now, int64_t highest_seq,
+                      std::vector<uint16_t>& loss_packet_seqs);
+  uint32_t nb_suppressed_nacks() const { return nb_suppressed_nacks_; }
+  uint32_t nb_nacked_seqs() const { return nb_nacked_seqs_; }
+  // Nacked seqs whose original packet arrived after all, so the
+  // retransmission was not needed.
+  uint32_t nb_spurious_nacks() const { return nb_spurious_nacks_; }
+  uint32_t reorder_wait_packets() const { return reorder_wait_packets_; }
+  uint32_t reorder_wait_ms() const { return reorder_wait_ms_; }
+
+ private:
+  // Together they give the fixed 50 ms interval used before the rtt is
+  // known.
+  static constexpr uint32_t kDefaultRttMs = 40;
+  static constexpr uint32_t kMinNackMarginMs = 10;
+  static constexpr uint32_t kMaxNackIntervalMs = 1000;
+  static constexpr uint16_t kMaxNbNacks = 10;
+  static constexpr uint32_t kMaxNackAgeMs = 2000;
+  // The last bucket also counts everything above it.
+  static constexpr uint32_t kNbReorderBuckets = 64;
+  static constexpr uint32_t kReorderDelayBucketMs = 2;
+  // The wait covers this share of the reordered packets.
+  static constexpr uint32_t kReorderPercentile = 95;
+  // The histograms are halved when they hold that many samples, so that
+  // the wait follows changes of the path.
+  static constexpr uint32_t kMaxNbReorderSamples = 1024;
+  using ReorderHistogram = std::array<uint32_t, kNbReorderBuckets>;
+  // Returns the first bucket at which kReorderPercentile of the samples are
+  // reached.
+  static uint32_t PercentileBucket(const ReorderHistogram& histogram,
+                                   uint32_t nb_samples);
+  void AddReorderSample(int64_t reorder_distance, uint32_t reorder_delay_ms);
+  struct NackState {
+    // Milliseconds since time_base_utc_ms_.
+    uint32_t first_seen_ms;
+    uint32_t last_sent_ms;
+    uint32_t deadline_ms;
+    uint16_t nb_sent;
+  };
+  bool IsMissing(int64_t unwrapped_seq) const;
+  // Clears the bits of [from, to).
+  void ClearRange(int64_t from, int64_t to);
+  uint32_t capacity_;
+  uint32_t mask_;
+  std::vector<uint64_t> missing_;
+  std::vector<NackState> nack_states_;
+  uint64_t time_base_utc_ms_;
+  uint32_t nack_interval_ms_;
+  // 0 until the rtt is measured.
+  uint32_t rtt_ms_;
+  uint32_t nb_suppressed_nacks_;
+  uint32_t nb_nacked_seqs_;
+  uint32_t nb_spurious_nacks_;
+  ReorderHistogram reorder_distances_;
+  ReorderHistogram reorder_delays_;
+  uint32_t nb_reorder_samples_;
+  // A missing seq is nacked once this many later seqs were received or it
+  // has been missing for reorder_wait_ms_, whichever comes first.
+  uint32_t reorder_wait_packets_;
+  uint32_t reorder_wait_ms_;
+  // Tracked window [begin_seq_, end_seq_), bits outside of it are all 0.
+  int64_t begin_seq_;
+  int64_t end_seq_;
+};
+}  // namespace qosrtp
\ No newline at end of file
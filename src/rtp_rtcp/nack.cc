@@ -57,16 +57,16 @@ void Nack::Unpack() {
   }
 }
 
-std::unique_ptr<Result> Nack::LoadPacket(uint8_t* packet, uint32_t* pos,
-                                         uint32_t max_length) const {
+Status Nack::LoadPacket(uint8_t* packet, uint32_t* pos,
+                        uint32_t max_length) const {
   if (packed_.empty()) {
-    return Result::Create(
-        -1, "A nack package can only be generated when FCI is not empty.");
+    return Status::Error(
+        "A nack package can only be generated when FCI is not empty.");
   }
   if (*pos + BlockLength() > max_length) {
-    return Result::Create(-1,
-                          "The remaining buffer space is less than the length "
-                          "of the loaded packet");
+    return Status::Error(
+        "The remaining buffer space is less than the length "
+        "of the loaded packet");
   }
   uint32_t payload_size_32bits =
       (BlockLength() - kHeaderLength) / sizeof(uint32_t);
@@ -80,18 +80,18 @@ std::unique_ptr<Result> Nack::LoadPacket(uint8_t* packet, uint32_t* pos,
     ByteWriter<uint16_t>::WriteBigEndian(packet + *pos + 2, item.bitmask);
     *pos += kNackItemLength;
   }
-  return Result::Create();
+  return Status::Ok();
 }
 
-std::unique_ptr<Result> Nack::StorePacket(const CommonHeader& packet) {
+Status Nack::StorePacket(const CommonHeader& packet) {
   if (kPacketType != packet.type() || kFeedbackMessageType != packet.fmt()) {
-    return Result::Create(
-        -1, "The settings of PT and FMT are inconsistent with nack.");
+    return Status::Error(
+        "The settings of PT and FMT are inconsistent with nack.");
   }
   if (packet.payload_size_bytes() < kCommonFeedbackLength + kNackItemLength) {
-    return Result::Create(-1,
-                          "The packet length is less than the minimum "
-                          "effective length of the nack packet.");
+    return Status::Error(
+        "The packet length is less than the minimum "
+        "effective length of the nack packet.");
   }
   size_t nack_items =
       (packet.payload_size_bytes() - kCommonFeedbackLength) / kNackItemLength;
@@ -105,5 +105,5 @@ std::unique_ptr<Result> Nack::StorePacket(const CommonHeader& packet) {
     next_nack += kNackItemLength;
   }
   Unpack();
-  return Result::Create();
+  return Status::Ok();
 }
\ No newline at end of file
@@ -37,14 +37,14 @@ class Nack : public Rtpfb {
   virtual ~Nack() override;
 
   // Parse assumes header is already parsed and validated.
-  std::unique_ptr<Result> StorePacket(const CommonHeader& packet);
+  Status StorePacket(const CommonHeader& packet);
   // The number in nack_list must "increase" with index
   void SetPacketIds(const uint16_t* nack_list, uint32_t length);
   void SetPacketIds(std::vector<uint16_t> nack_list);
 
   const std::vector<uint16_t>& packet_ids() const { return packet_ids_; }
   virtual uint32_t BlockLength() const override;
-  virtual std::unique_ptr<Result> LoadPacket(
+  virtual Status LoadPacket(
       uint8_t* packet, uint32_t* pos, uint32_t max_length) const override;
 
  private:
@@ -0,0 +1,183 @@
+#include "./pacer.h"
+
+#include <algorithm>
+
+namespace qosrtp {
+SendQueueStatistics::SendQueueStatistics()
+    : packets_dropped_expired(0), packets_dropped_droppable(0) {
+  for (std::atomic<uint32_t>& bucket : queue_delay_histogram) bucket = 0;
+}
+
+SendQueueStatistics::~SendQueueStatistics() = default;
+
+SendFrameState::SendFrameState() : dropped(false) {}
+
+SendFrameState::~SendFrameState() = default;
+
+void SendQueueStatistics::AddQueueDelay(uint64_t queue_delay_us) {
+  uint64_t queue_delay_ms = queue_delay_us / 1000;
+  uint32_t index = 0;
+  while ((0 != queue_delay_ms) && (index + 1 < kNbQueueDelayBuckets)) {
+    queue_delay_ms >>= 1;
+    ++index;
+  }
+  queue_delay_histogram[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+RtpPacer::RtpPacer(uint32_t rate_bps, uint32_t burst_bytes,
+                   uint64_t time_us_now)
+    : rate_bps_(0),
+      budget_microbits_(0),
+      max_budget_microbits_(0),
+      last_update_time_us_(time_us_now),
+      nb_queued_packets_(0),
+      queued_bytes_(0) {
+  queues_bytes_.fill(0);
+  SetRate(rate_bps, burst_bytes, time_us_now);
+  budget_microbits_ = max_budget_microbits_;
+}
+
+RtpPacer::~RtpPacer() = default;
+
+void RtpPacer::SetRate(uint32_t rate_bps, uint32_t burst_bytes,
+                       uint64_t time_us_now) {
+  // The budget gained so far is counted at the previous rate.
+  UpdateBudget(time_us_now);
+  rate_bps_ = rate_bps;
+  if (0 == burst_bytes) burst_bytes = kDefaultBurstBytes;
+  max_budget_microbits_ =
+      static_cast<int64_t>(burst_bytes) * kMicrobitsPerByte;
+  budget_microbits_ = std::min(budget_microbits_, max_budget_microbits_);
+}
+
+void RtpPacer::Enqueue(PacketPriority priority, PacedPacket packet,
+                       uint64_t time_us_now) {
+  uint32_t index = static_cast<uint32_t>(priority);
+  if (index >= kNbPriorities) index = kNbPriorities - 1;
+  if (packet.IsDropped(time_us_now)) {
+    Drop(packet, packet.IsExpired(time_us_now));
+    return;
+  }
+  if ((0 != packet.info.deadline_us) && (0 != rate_bps_)) {
+    UpdateBudget(time_us_now);
+    if (time_us_now + DrainTimeUs(index) > packet.info.deadline_us) {
+      if (packet.info.droppable) {
+        Drop(packet, false);
+        // Along with the packets of its frame queued before it.
+        DropQueued(false);
+        return;
+      }
+      DropQueued(true);
+    }
+  }
+  ++nb_queued_packets_;
+  queued_bytes_ += packet.size;
+  queues_bytes_[index] += packet.size;
+  queues_[index].push_back(std::move(packet));
+}
+
+bool RtpPacer::Dequeue(uint64_t time_us_now, PacedPacket* packet) {
+  if (0 == nb_queued_packets_) return false;
+  UpdateBudget(time_us_now);
+  if (budget_microbits_ <= 0) return false;
+  for (uint32_t index = 0; index < kNbPriorities; ++index) {
+    std::deque<PacedPacket>& queue = queues_[index];
+    while (!queue.empty() && queue.front().IsDropped(time_us_now)) {
+      Drop(queue.front(), queue.front().IsExpired(time_us_now));
+      --nb_queued_packets_;
+      queued_bytes_ -= queue.front().size;
+      queues_bytes_[index] -= queue.front().size;
+      queue.pop_front();
+    }
+    if (queue.empty()) continue;
+    *packet = std::move(queue.front());
+    queue.pop_front();
+    --nb_queued_packets_;
+    queued_bytes_ -= packet->size;
+    queues_bytes_[index] -= packet->size;
+    budget_microbits_ -=
+        static_cast<int64_t>(packet->size) * kMicrobitsPerByte;
+    return true;
+  }
+  return false;
+}
+
+void RtpPacer::TakeAll(std::vector<PacedPacket>& out_packets) {
+  for (std::deque<PacedPacket>& queue : queues_) {
+    for (PacedPacket& packet : queue) {
+      out_packets.push_back(std::move(packet));
+    }
+    queue.clear();
+  }
+  nb_queued_packets_ = 0;
+  queued_bytes_ = 0;
+  queues_bytes_.fill(0);
+}
+
+uint64_t RtpPacer::TimeUntilNextSendUs(uint64_t time_us_now) {
+  if (0 == nb_queued_packets_) return kNoPacketQueued;
+  UpdateBudget(time_us_now);
+  if (budget_microbits_ > 0) return 0;
+  if (0 == rate_bps_) return kNoPacketQueued;
+  // The first microsecond in which the budget is positive again.
+  return static_cast<uint64_t>(-budget_microbits_) / rate_bps_ + 1;
+}
+
+uint64_t RtpPacer::DrainTimeUs(uint32_t index) const {
+  int64_t microbits = -budget_microbits_;
+  for (uint32_t i = 0; i <= index; ++i) {
+    microbits += static_cast<int64_t>(queues_bytes_[i]) * kMicrobitsPerByte;
+  }
+  if (microbits <= 0) return 0;
+  return static_cast<uint64_t>(microbits) / rate_bps_;
+}
+
+void RtpPacer::DropQueued(bool droppable) {
+  // The fec packets of a frame are queued after its media packets, which
+  // mark the frame dropped first.
+  for (uint32_t index = 0; index < kNbPriorities; ++index) {
+    std::deque<PacedPacket>& queue = queues_[index];
+    // Unlike remove_if, keeps the dropped packets intact for Drop.
+    auto iter_dropped = std::stable_partition(
+        queue.begin(), queue.end(), [droppable](const PacedPacket& packet) {
+          return !(droppable && packet.info.droppable) &&
+                 !((nullptr != packet.info.frame) &&
+                   packet.info.frame->dropped.load());
+        });
+    for (auto iter = iter_dropped; iter != queue.end(); ++iter) {
+      Drop(*iter, false);
+      --nb_queued_packets_;
+      queued_bytes_ -= iter->size;
+      queues_bytes_[index] -= iter->size;
+    }
+    queue.erase(iter_dropped, queue.end());
+  }
+}
+
+void RtpPacer::Drop(const PacedPacket& packet, bool expired) {
+  if (nullptr != packet.info.frame) packet.info.frame->dropped.store(true);
+  if (nullptr == packet.info.statistics) return;
+  if (expired) {
+    packet.info.statistics->packets_dropped_expired.fetch_add(
+        1, std::memory_order_relaxed);
+  } else {
+    packet.info.statistics->packets_dropped_droppable.fetch_add(
+        1, std::memory_order_relaxed);
+  }
+}
+
+void RtpPacer::UpdateBudget(uint64_t time_us_now) {
+  if (time_us_now <= last_update_time_us_) return;
+  uint64_t elapsed_us = time_us_now - last_update_time_us_;
+  last_update_time_us_ = time_us_now;
+  // Capping elapsed_us first keeps the product from overflowing after a
+  // long idle period.
+  uint64_t max_elapsed_us =
+      (0 == rate_bps_)
+          ? 0
+          : static_cast<uint64_t>(max_budget_microbits_) / rate_bps_ + 1;
+  elapsed_us = std::min(elapsed_us, max_elapsed_us);
+  budget_microbits_ += static_cast<int64_t>(elapsed_us * rate_bps_);
+  budget_microbits_ = std::min(budget_microbits_, max_budget_microbits_);
+}
+}  // namespace qosrtp
\ No newline at end of file
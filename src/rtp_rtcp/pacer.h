@@ -0,0 +1,134 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../include/data_buffer.h"
+#include "../include/rtp_packet.h"
+
+namespace qosrtp {
+// The queues of the pacer, lower values are sent first.
+enum class PacketPriority : uint8_t {
+  kAudio = 0,
+  kVideo,
+  kRtx,
+  kFec,
+  kPadding,
+};
+
+// The packets of one media session dropped on their way to the network and
+// the time the sent ones were queued for, updated by the network thread and
+// read by the rtp sender.
+struct SendQueueStatistics {
+  // Buckets of [0, 1), [1, 2), [2, 4) ... [512, inf) ms.
+  static constexpr uint32_t kNbQueueDelayBuckets = 11;
+  SendQueueStatistics();
+  ~SendQueueStatistics();
+  void AddQueueDelay(uint64_t queue_delay_us);
+  std::atomic<uint32_t> packets_dropped_expired;
+  std::atomic<uint32_t> packets_dropped_droppable;
+  std::array<std::atomic<uint32_t>, kNbQueueDelayBuckets> queue_delay_histogram;
+};
+
+// Shared by the packets of one frame, set by the network thread once one of
+// them is dropped so that the rest of the frame is dropped too, and read by
+// the rtp sender so that none of them is retransmitted.
+struct SendFrameState {
+  SendFrameState();
+  ~SendFrameState();
+  std::atomic<bool> dropped;
+};
+
+// What the frame of a media packet allows on its way to the network.
+struct PacketSendInfo {
+  // SteadyTimeMicros when the frame was handed to the media session.
+  uint64_t enqueue_time_us = 0;
+  // SteadyTimeMicros after which the packet is dropped, 0 for none.
+  uint64_t deadline_us = 0;
+  // Dropped first when the packets queue up, e.g. non-reference frames.
+  bool droppable = false;
+  // nullptr if the packet is never dropped.
+  std::shared_ptr<SendFrameState> frame;
+  std::shared_ptr<SendQueueStatistics> statistics;
+};
+
+// A packet waiting in the pacer. data is sent first, followed by the payload
+// of payload_of if it is set, as for the rtx packets whose payload stays in
+// the send history.
+struct PacedPacket {
+  std::unique_ptr<DataBuffer> data;
+  std::shared_ptr<const RtpPacket> payload_of;
+  uint32_t size = 0;
+  PacketSendInfo info;
+  bool IsExpired(uint64_t time_us_now) const {
+    return (0 != info.deadline_us) && (time_us_now > info.deadline_us);
+  }
+  // Expired, or another packet of its frame was dropped.
+  bool IsDropped(uint64_t time_us_now) const {
+    return IsExpired(time_us_now) ||
+           ((nullptr != info.frame) && info.frame->dropped.load());
+  }
+};
+
+/* This class is not thread-safe */
+// Releases the packets at rate_bps on average. A token bucket gains budget
+// with the elapsed time in microseconds, up to burst_bytes. A packet is
+// released while the budget is positive and its size is taken from the
+// budget, so one large packet may overdraw it and delays the next ones.
+// The queues are served in strict priority order, the packets of one
+// priority in the order they came. Packets past their deadline are dropped
+// instead of being released. A packet that could not be sent before its
+// deadline behind the queued ones of the same or a higher priority is
+// dropped if it is droppable, and makes the droppable packets queued be
+// dropped otherwise. Frames are dropped whole, the packets of a frame one of
+// which was dropped are dropped as they come or reach the head of a queue.
+class RtpPacer {
+ public:
+  static constexpr uint64_t kNoPacketQueued =
+      std::numeric_limits<uint64_t>::max();
+  static constexpr uint32_t kDefaultBurstBytes = 16 * 1024;
+  // 0 for burst_bytes uses kDefaultBurstBytes.
+  RtpPacer(uint32_t rate_bps, uint32_t burst_bytes, uint64_t time_us_now);
+  ~RtpPacer();
+  void SetRate(uint32_t rate_bps, uint32_t burst_bytes, uint64_t time_us_now);
+  void Enqueue(PacketPriority priority, PacedPacket packet,
+               uint64_t time_us_now);
+  // Returns false if no packet may be released at time_us_now.
+  bool Dequeue(uint64_t time_us_now, PacedPacket* packet);
+  // Removes all queued packets in the order they would have been released.
+  void TakeAll(std::vector<PacedPacket>& out_packets);
+  // Microseconds until Dequeue releases the next packet, kNoPacketQueued if
+  // the queues are empty.
+  uint64_t TimeUntilNextSendUs(uint64_t time_us_now);
+  uint32_t nb_queued_packets() const { return nb_queued_packets_; }
+  uint32_t queued_bytes() const { return queued_bytes_; }
+  // Counts the packet as dropped, past its deadline if expired, and marks
+  // its frame dropped.
+  static void Drop(const PacedPacket& packet, bool expired);
+
+ private:
+  static constexpr uint32_t kNbPriorities =
+      static_cast<uint32_t>(PacketPriority::kPadding) + 1;
+  static constexpr int64_t kMicrobitsPerByte = 8 * 1000 * 1000;
+  void UpdateBudget(uint64_t time_us_now);
+  // Microseconds to release the queued packets up to index.
+  uint64_t DrainTimeUs(uint32_t index) const;
+  // Drops the queued packets whose frame was dropped, and the droppable ones
+  // as well if droppable.
+  void DropQueued(bool droppable);
+  std::array<std::deque<PacedPacket>, kNbPriorities> queues_;
+  std::array<uint32_t, kNbPriorities> queues_bytes_;
+  uint32_t rate_bps_;
+  // In bits * 10^-6, so that rate_bps * elapsed microseconds adds to it
+  // without rounding.
+  int64_t budget_microbits_;
+  int64_t max_budget_microbits_;
+  uint64_t last_update_time_us_;
+  uint32_t nb_queued_packets_;
+  uint32_t queued_bytes_;
+};
+}  // namespace qosrtp
\ No newline at end of file
@@ -0,0 +1,30 @@
+#include "./payload_type_table.h"
+
+namespace qosrtp {
+PayloadTypeTable::PayloadTypeTable() {
+  is_media_.fill(false);
+  rtx_of_media_.fill(kNone);
+  media_of_rtx_.fill(kNone);
+}
+
+PayloadTypeTable::~PayloadTypeTable() = default;
+
+void PayloadTypeTable::Build(
+    const std::vector<uint8_t>& payload_types,
+    const std::map<uint8_t, uint8_t>& map_rtx_payload_type) {
+  is_media_.fill(false);
+  rtx_of_media_.fill(kNone);
+  media_of_rtx_.fill(kNone);
+  for (uint8_t pt : payload_types) {
+    if (pt < kNbPayloadTypes) is_media_[pt] = true;
+  }
+  // The map is ordered by rtx payload type, the first one found wins.
+  for (const auto& element : map_rtx_payload_type) {
+    uint8_t rtx_pt = element.first;
+    uint8_t pt = element.second;
+    if ((rtx_pt >= kNbPayloadTypes) || (pt >= kNbPayloadTypes)) continue;
+    media_of_rtx_[rtx_pt] = pt;
+    if (kNone == rtx_of_media_[pt]) rtx_of_media_[pt] = rtx_pt;
+  }
+}
+}  // namespace qosrtp
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace qosrtp {
+// The payload types of one rtp stream and their rtx payload types, in flat
+// tables indexed by the 7 bit payload type. Built once when the sender or
+// receiver is initialized, so a lookup per packet is a single load.
+class PayloadTypeTable {
+ public:
+  static constexpr uint8_t kNone = 0xFF;
+  static constexpr uint32_t kNbPayloadTypes = 128;
+  PayloadTypeTable();
+  ~PayloadTypeTable();
+  // Payload types above 0x7F are ignored. If several rtx payload types are
+  // associated with one payload type, the lowest one is used for it.
+  void Build(const std::vector<uint8_t>& payload_types,
+             const std::map<uint8_t, uint8_t>& map_rtx_payload_type);
+  // The marker bit of pt is ignored in the lookups below.
+  bool IsMedia(uint8_t pt) const { return is_media_[pt & 0x7F]; }
+  // kNone if pt has no rtx payload type.
+  uint8_t RtxPayloadType(uint8_t pt) const { return rtx_of_media_[pt & 0x7F]; }
+  // kNone if rtx_pt is not an rtx payload type.
+  uint8_t AssociatedPayloadType(uint8_t rtx_pt) const {
+    return media_of_rtx_[rtx_pt & 0x7F];
+  }
+
+ private:
+  std::array<bool, kNbPayloadTypes> is_media_;
+  std::array<uint8_t, kNbPayloadTypes> rtx_of_media_;
+  std::array<uint8_t, kNbPayloadTypes> media_of_rtx_;
+};
+}  // namespace qosrtp
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "pli.h"
+
+using namespace qosrtp;
+using namespace rtcp;
+
+Pli::Pli() = default;
+
+Pli::~Pli() = default;
+
+uint32_t Pli::BlockLength() const {
+  return kHeaderLength + kCommonFeedbackLength;
+}
+
+Status Pli::LoadPacket(uint8_t* packet, uint32_t* pos,
+                       uint32_t max_length) const {
+  if (*pos + BlockLength() > max_length) {
+    return Status::Error(
+        "The remaining buffer space is less than the length "
+        "of the loaded packet");
+  }
+  uint32_t payload_size_32bits =
+      (BlockLength() - kHeaderLength) / sizeof(uint32_t);
+  CreateHeader(kFeedbackMessageType, kPacketType, payload_size_32bits, packet,
+               pos);
+  LoadCommonFeedback(packet + *pos);
+  *pos += kCommonFeedbackLength;
+  return Status::Ok();
+}
+
+Status Pli::StorePacket(const CommonHeader& packet) {
+  if (kPacketType != packet.type() || kFeedbackMessageType != packet.fmt()) {
+    return Status::Error(
+        "The settings of PT and FMT are inconsistent with pli.");
+  }
+  if (packet.payload_size_bytes() < kCommonFeedbackLength) {
+    return Status::Error(
+        "The packet length is less than the minimum "
+        "effective length of the pli packet.");
+  }
+  StoreCommonFeedback(packet.payload());
+  return Status::Ok();
+}
\ No newline at end of file
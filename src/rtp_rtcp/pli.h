@@ -0,0 +1,24 @@
+#pragma once
+#include "common_header.h"
+#include "psfb.h"
+
+namespace qosrtp {
+namespace rtcp {
+// RFC 4585, Section 6.3.1: Picture Loss Indication (PLI).
+//
+// PLI has no FCI, the common feedback header is the whole packet. It asks
+// the media sender for a key frame.
+class Pli : public Psfb {
+ public:
+  static constexpr uint8_t kFeedbackMessageType = 1;
+  Pli();
+  virtual ~Pli() override;
+
+  // Parse assumes header is already parsed and validated.
+  Status StorePacket(const CommonHeader& packet);
+  virtual uint32_t BlockLength() const override;
+  virtual Status LoadPacket(
+      uint8_t* packet, uint32_t* pos, uint32_t max_length) const override;
+};
+}  // namespace rtcp
+}  // namespace qosrtp
\ No newline at end of file
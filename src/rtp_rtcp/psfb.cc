@@ -0,0 +1,20 @@
+#include "./psfb.h"
+
+#include "../utils/byte_io.h"
+
+using namespace qosrtp;
+using namespace rtcp;
+
+Psfb::Psfb() = default;
+
+Psfb::~Psfb() = default;
+
+void Psfb::StoreCommonFeedback(const uint8_t* payload) {
+  SetSenderSsrc(ByteReader<uint32_t>::ReadBigEndian(&payload[0]));
+  SetMediaSsrc(ByteReader<uint32_t>::ReadBigEndian(&payload[4]));
+}
+
+void Psfb::LoadCommonFeedback(uint8_t* payload) const {
+  ByteWriter<uint32_t>::WriteBigEndian(&payload[0], sender_ssrc());
+  ByteWriter<uint32_t>::WriteBigEndian(&payload[4], media_ssrc());
+}
\ No newline at end of file
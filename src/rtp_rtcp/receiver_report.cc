@@ -16,13 +16,13 @@ uint32_t ReceiverReport::BlockLength() const {
          report_blocks_.size() * ReportBlock::kLength;
 }
 
-std::unique_ptr<Result> ReceiverReport::LoadPacket(uint8_t* packet,
-                                                   uint32_t* pos,
-                                                   uint32_t max_length) const {
+Status ReceiverReport::LoadPacket(uint8_t* packet,
+                                  uint32_t* pos,
+                                  uint32_t max_length) const {
   if (*pos + BlockLength() > max_length) {
-    return Result::Create(-1,
-                          "The remaining buffer space is less than the length "
-                          "of the loaded packet");
+    return Status::Error(
+        "The remaining buffer space is less than the length "
+        "of the loaded packet");
   }
   RtcpPacket::CreateHeader(report_blocks_.size(), ReceiverReport::kPacketType,
                            (BlockLength() - kHeaderLength) / sizeof(uint32_t),
@@ -33,30 +33,29 @@ std::unique_ptr<Result> ReceiverReport::LoadPacket(uint8_t* packet,
     block->LoadPacket(packet + *pos);
     *pos += ReportBlock::kLength;
   }
-  return Result::Create();
+  return Status::Ok();
 }
 
-std::unique_ptr<Result> ReceiverReport::StorePacket(
-    const CommonHeader& packet) {
+Status ReceiverReport::StorePacket(const CommonHeader& packet) {
   if (kPacketType != packet.type()) {
-    return Result::Create(-1, "The type of rtcp is not receiver report.");
+    return Status::Error("The type of rtcp is not receiver report.");
   }
   if (packet.payload() == nullptr) {
-    return Result::Create(
-        -1, "It is meaningless to parse a package with a payload of nullptr");
+    return Status::Error(
+        "It is meaningless to parse a package with a payload of nullptr");
   }
   const uint8_t report_blocks_count = packet.count();
   if (packet.payload_size_bytes() <
       kRrBaseLength + report_blocks_count * ReportBlock::kLength) {
-    return Result::Create(-1, "Packet is too small to contain all the data.");
+    return Status::Error("Packet is too small to contain all the data.");
   }
   if (packet.payload_size_bytes() >
       kRrBaseLength + report_blocks_count * ReportBlock::kLength) {
     uint32_t extensions_length = packet.payload_size_bytes() - kRrBaseLength +
                                  report_blocks_count * ReportBlock::kLength;
     if ((extensions_length % 4) != 0) {
-      return Result::Create(
-          -1, "The length of the rtcp extension must be divisible by 4.");
+      return Status::Error(
+          "The length of the rtcp extension must be divisible by 4.");
     }
     // It does not intend to process the extension, nor does it intend to inform
     // the caller of the extension. The processing of the report is isolated
@@ -70,23 +69,22 @@ std::unique_ptr<Result> ReceiverReport::StorePacket(
     block->StorePacket(next_report_block);
     next_report_block += ReportBlock::kLength;
   }
-  return Result::Create();
+  return Status::Ok();
 }
 
-std::unique_ptr<Result> ReceiverReport::AddReportBlock(
-    std::unique_ptr<ReportBlock> block) {
+Status ReceiverReport::AddReportBlock(std::unique_ptr<ReportBlock> block) {
   if (report_blocks_.size() >= kMaxNumberOfReportBlocks) {
-    return Result::Create(-1, "Max report blocks reached.");
+    return Status::Error("Max report blocks reached.");
   }
   report_blocks_.push_back(std::move(block));
-  return Result::Create();
+  return Status::Ok();
 }
 
-std::unique_ptr<Result> ReceiverReport::SetReportBlocks(
+Status ReceiverReport::SetReportBlocks(
     std::vector<std::unique_ptr<ReportBlock>> blocks) {
   if (blocks.size() > kMaxNumberOfReportBlocks) {
-    return Result::Create(-1, "Max report blocks reached.");
+    return Status::Error("Max report blocks reached.");
   }
   report_blocks_ = std::move(blocks);
-  return Result::Create();
+  return Status::Ok();
 }
\ No newline at end of file
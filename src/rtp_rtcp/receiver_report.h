@@ -2,7 +2,7 @@
 #include <memory>
 #include <vector>
 
-#include "../include/result.h"
+#include "../utils/status.h"
 #include "common_header.h"
 #include "report_block.h"
 #include "rtcp_packet.h"
@@ -30,7 +30,7 @@ class ReceiverReport : public RtcpPacket {
 
   virtual uint32_t BlockLength() const override;
 
-  virtual std::unique_ptr<Result> LoadPacket(
+  virtual Status LoadPacket(
       uint8_t* packet, uint32_t* pos, uint32_t max_length) const override;
   const std::vector<const ReportBlock*> report_blocks() const {
     std::vector<const ReportBlock*> ret;
@@ -40,10 +40,9 @@ class ReceiverReport : public RtcpPacket {
     return ret;
   }
 
-  std::unique_ptr<Result> StorePacket(const CommonHeader& packet);
-  std::unique_ptr<Result> AddReportBlock(std::unique_ptr<ReportBlock> block);
-  std::unique_ptr<Result> SetReportBlocks(
-      std::vector<std::unique_ptr<ReportBlock>> blocks);
+  Status StorePacket(const CommonHeader& packet);
+  Status AddReportBlock(std::unique_ptr<ReportBlock> block);
+  Status SetReportBlocks(std::vector<std::unique_ptr<ReportBlock>> blocks);
 
  private:
   static const size_t kRrBaseLength = 4;
@@ -16,15 +16,13 @@ ReportBlock::ReportBlock()
 
 ReportBlock::~ReportBlock() = default;
 
-std::unique_ptr<Result> ReportBlock::SetCumulativeLost(
-    int32_t cumulative_lost) {
+Status ReportBlock::SetCumulativeLost(int32_t cumulative_lost) {
   // We have only 3 bytes to store it, and it's a signed value.
   if (cumulative_lost >= (1 << 23) || cumulative_lost < -(1 << 23)) {
-    return Result::Create(
-        -1, "Cumulative lost is too big to fit into Report Block");
+    return Status::Error("Cumulative lost is too big to fit into Report Block");
   }
   cumulative_lost_ = cumulative_lost;
-  return Result::Create();
+  return Status::Ok();
 }
 
 void ReportBlock::LoadPacket(uint8_t* buffer) const {
@@ -37,7 +35,7 @@ void ReportBlock::LoadPacket(uint8_t* buffer) const {
   ByteWriter<uint32_t>::WriteBigEndian(&buffer[20], delay_since_last_sr_);
 }
 
-std::unique_ptr<Result> ReportBlock::StorePacket(const uint8_t* buffer) {
+Status ReportBlock::StorePacket(const uint8_t* buffer) {
   source_ssrc_ = ByteReader<uint32_t>::ReadBigEndian(&buffer[0]);
   fraction_lost_ = buffer[4];
   cumulative_lost_ = ByteReader<int32_t, 3>::ReadBigEndian(&buffer[5]);
@@ -45,5 +43,5 @@ std::unique_ptr<Result> ReportBlock::StorePacket(const uint8_t* buffer) {
   jitter_ = ByteReader<uint32_t>::ReadBigEndian(&buffer[12]);
   last_sr_ = ByteReader<uint32_t>::ReadBigEndian(&buffer[16]);
   delay_since_last_sr_ = ByteReader<uint32_t>::ReadBigEndian(&buffer[20]);
-  return Result::Create();
+  return Status::Ok();
 }
\ No newline at end of file
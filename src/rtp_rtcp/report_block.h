@@ -2,7 +2,7 @@
 #include <memory>
 
 #include "../include/data_buffer.h"
-#include "../include/result.h"
+#include "../utils/status.h"
 
 namespace qosrtp {
 namespace rtcp {
@@ -31,12 +31,12 @@ class ReportBlock {
   ReportBlock();
   ~ReportBlock();
 
-  std::unique_ptr<Result> StorePacket(const uint8_t* buffer);
+  Status StorePacket(const uint8_t* buffer);
   void SetMediaSsrc(uint32_t ssrc) { source_ssrc_ = ssrc; }
   void SetFractionLost(uint8_t fraction_lost) {
     fraction_lost_ = fraction_lost;
   }
-  std::unique_ptr<Result> SetCumulativeLost(int32_t cumulative_lost);
+  Status SetCumulativeLost(int32_t cumulative_lost);
   void SetExtHighestSeqNum(uint32_t ext_highest_seq_num) {
     extended_high_seq_num_ = ext_highest_seq_num;
   }
@@ -2,7 +2,7 @@
 #include <memory>
 
 #include "../include/data_buffer.h"
-#include "../include/result.h"
+#include "../utils/status.h"
 
 namespace qosrtp {
 namespace rtcp {
@@ -20,8 +20,8 @@ class RtcpPacket {
   // When passed in, pos represents where the data is written. After returning,
   // pos represents the next position at the end of the packet.
   // max_length refers to the memory size allocated after the packet pointer
-  virtual std::unique_ptr<Result> LoadPacket(uint8_t* packet, uint32_t* pos,
-                                             uint32_t max_length) const = 0;
+  virtual Status LoadPacket(uint8_t* packet, uint32_t* pos,
+                            uint32_t max_length) const = 0;
   void SetSenderSsrc(uint32_t ssrc) { sender_ssrc_ = ssrc; }
   uint32_t sender_ssrc() const { return sender_ssrc_; }
 
@@ -34,12 +34,12 @@ class RtcpPacket {
   //  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   //  |V=2|P| RC/FMT  |      PT       |             length            |
   //  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-  static std::unique_ptr<Result> CreateHeader(
+  static Status CreateHeader(
       uint8_t count_or_format, uint8_t packet_type,
       uint16_t length,  // Payload size in 32bit words.
       uint8_t* buffer, uint32_t* pos) {
     if (count_or_format > (uint8_t)0x1f) {
-      return Result::Create(-1, "count_or_format is bigger than 0x1f.");
+      return Status::Error("count_or_format is bigger than 0x1f.");
     }
     constexpr uint8_t kVersionBits = 2 << 6;
     buffer[*pos + 0] = kVersionBits | count_or_format;
@@ -47,7 +47,7 @@ class RtcpPacket {
     buffer[*pos + 2] = (length >> 8) & 0xff;
     buffer[*pos + 3] = length & 0xff;
     *pos += kHeaderLength;
-    return Result::Create();
+    return Status::Ok();
   }
   uint32_t sender_ssrc_;
 };
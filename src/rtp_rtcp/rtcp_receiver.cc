@@ -18,7 +18,10 @@ RtcpReceiver::RtcpReceiver()
       has_received_bye_(false),
       has_received_sender_report_(false),
       ntp_last_sender_report_(0),
-      ms_receive_last_sr_(0) {}
+      ms_receive_last_sr_(0),
+      has_received_rrtr_(false),
+      ntp_last_rrtr_(0),
+      ms_receive_last_rrtr_(0) {}
 
 RtcpReceiver::~RtcpReceiver() = default;
 
@@ -37,9 +40,9 @@ std::unique_ptr<Result> RtcpReceiver::Initialize(
   return Result::Create();
 }
 
-void RtcpReceiver::OnRtcpPacket(const DataBuffer* data_buffer) {
+void RtcpReceiver::OnRtcpPacket(const DataBuffer* data_buffer, Arena* arena) {
   if ((nullptr == data_buffer) || has_received_bye_) return;
-  std::unique_ptr<PacketInformation> info = Parse(data_buffer);
+  PacketInformation* info = Parse(data_buffer, arena);
   if (nullptr == info) {
     QOSRTP_LOG(Error, "Failed to parse rtcp information");
     return;
@@ -47,47 +50,54 @@ void RtcpReceiver::OnRtcpPacket(const DataBuffer* data_buffer) {
   return;
 }
 
-std::unique_ptr<RtcpReceiver::PacketInformation> RtcpReceiver::Parse(
-    const DataBuffer* data_buffer) {
-  std::unique_ptr<rtcp::CommonHeader> compound_packet =
-      std::make_unique<rtcp::CommonHeader>();
+RtcpReceiver::PacketInformation* RtcpReceiver::Parse(
+    const DataBuffer* data_buffer, Arena* arena) {
+  rtcp::CommonHeader* compound_packet = arena->New<rtcp::CommonHeader>();
   const uint8_t* next_packet = data_buffer->Get();
-  std::unique_ptr<PacketInformation> info =
-      std::make_unique<PacketInformation>();
+  PacketInformation* info = arena->New<PacketInformation>();
   for (;;) {
     uint32_t remain_length =
         data_buffer->size() - (next_packet - data_buffer->Get());
     if (0 == remain_length) {
       break;
     }
-    std::unique_ptr<Result> result =
-        compound_packet->StorePacket(next_packet, remain_length);
-    if (!result->ok()) {
+    Status result = compound_packet->StorePacket(next_packet, remain_length);
+    if (!result.ok()) {
       QOSRTP_LOG(Error, "Failed to parse compound header, because: %s",
-                 result->description().c_str());
+                 result.description());
       return nullptr;
     }
     next_packet = compound_packet->NextPacket();
     switch (compound_packet->type()) {
       case rtcp::SenderReport::kPacketType:
-        ParseSenderReport(compound_packet.get(), info.get());
+        ParseSenderReport(compound_packet, info, arena);
         break;
       case rtcp::ReceiverReport::kPacketType:
-        ParseReceiverReport(compound_packet.get(), info.get());
+        ParseReceiverReport(compound_packet, info, arena);
         break;
       case rtcp::Sdes::kPacketType:
-        ParseSdes(compound_packet.get(), info.get());
+        ParseSdes(compound_packet, info, arena);
         break;
       case rtcp::Bye::kPacketType:
-        ParseBye(compound_packet.get(), info.get());
+        ParseBye(compound_packet, info, arena);
         break;
       case rtcp::Rtpfb::kPacketType:
         switch (compound_packet->fmt()) { 
         case rtcp::Nack::kFeedbackMessageType:
-          ParseNacks(compound_packet.get(), info.get());
+          ParseNacks(compound_packet, info, arena);
           break;
         }
         break;
+      case rtcp::Psfb::kPacketType:
+        switch (compound_packet->fmt()) {
+        case rtcp::Pli::kFeedbackMessageType:
+          ParsePli(compound_packet, info, arena);
+          break;
+        }
+        break;
+      case rtcp::ExtendedReports::kPacketType:
+        ParseExtendedReports(compound_packet, info, arena);
+        break;
       default:
         break;
     }
@@ -96,13 +106,12 @@ std::unique_ptr<RtcpReceiver::PacketInformation> RtcpReceiver::Parse(
 }
 
 void RtcpReceiver::ParseSenderReport(rtcp::CommonHeader* header,
-                                     PacketInformation* info) {
-  std::unique_ptr<rtcp::SenderReport> sr_packet =
-      std::make_unique<rtcp::SenderReport>();
-  std::unique_ptr<Result> result = sr_packet->StorePacket(*header);
-  if (!(result->ok())) {
+                                     PacketInformation* info, Arena* arena) {
+  rtcp::SenderReport* sr_packet = arena->New<rtcp::SenderReport>();
+  Status result = sr_packet->StorePacket(*header);
+  if (!(result.ok())) {
     QOSRTP_LOG(Error, "Failed to parse sender report, because: %s",
-               result->description().c_str());
+               result.description());
     return;
   }
   if (config_->remote_ssrc != sr_packet->sender_ssrc()) {
@@ -117,6 +126,11 @@ void RtcpReceiver::ParseSenderReport(rtcp::CommonHeader* header,
   if (!(report_blocks.empty())) {
     info->type_flags |= static_cast<uint32_t>(RTCPPacketType::kRtcpReport);
   }
+  for (const rtcp::ReportBlock* report_block : report_blocks) {
+    if (config_->local_ssrc == report_block->source_ssrc()) {
+      UpdateRtt(report_block->last_sr(), report_block->delay_since_last_sr());
+    }
+  }
   std::lock_guard<std::mutex> lock(mutex_);
   has_received_sender_report_ = true;
   ntp_last_sender_report_ = sr_packet->ntp();
@@ -125,13 +139,12 @@ void RtcpReceiver::ParseSenderReport(rtcp::CommonHeader* header,
 }
 
 void RtcpReceiver::ParseReceiverReport(rtcp::CommonHeader* header,
-                                       PacketInformation* info) {
-  std::unique_ptr<rtcp::ReceiverReport> rr_packet =
-      std::make_unique<rtcp::ReceiverReport>();
-  std::unique_ptr<Result> result = rr_packet->StorePacket(*header);
-  if (!(result->ok())) {
+                                       PacketInformation* info, Arena* arena) {
+  rtcp::ReceiverReport* rr_packet = arena->New<rtcp::ReceiverReport>();
+  Status result = rr_packet->StorePacket(*header);
+  if (!(result.ok())) {
     QOSRTP_LOG(Error, "Failed to parse receiver report, because: %s",
-               result->description().c_str());
+               result.description());
     return;
   }
   if (config_->remote_ssrc != rr_packet->sender_ssrc()) {
@@ -146,16 +159,21 @@ void RtcpReceiver::ParseReceiverReport(rtcp::CommonHeader* header,
   if (!(report_blocks.empty())) {
     info->type_flags |= static_cast<uint32_t>(RTCPPacketType::kRtcpReport);
   }
+  for (const rtcp::ReportBlock* report_block : report_blocks) {
+    if (config_->local_ssrc == report_block->source_ssrc()) {
+      UpdateRtt(report_block->last_sr(), report_block->delay_since_last_sr());
+    }
+  }
   return;
 }
 
 void RtcpReceiver::ParseSdes(rtcp::CommonHeader* header,
-                             PacketInformation* info) {
-  std::unique_ptr<rtcp::Sdes> sdes_packet = std::make_unique<rtcp::Sdes>();
-  std::unique_ptr<Result> result = sdes_packet->StorePacket(*header);
-  if (!(result->ok())) {
+                             PacketInformation* info, Arena* arena) {
+  rtcp::Sdes* sdes_packet = arena->New<rtcp::Sdes>();
+  Status result = sdes_packet->StorePacket(*header);
+  if (!(result.ok())) {
     QOSRTP_LOG(Error, "Failed to parse sdes, because: %s",
-               result->description().c_str());
+               result.description());
     return;
   }
   bool need = false;
@@ -178,12 +196,12 @@ void RtcpReceiver::ParseSdes(rtcp::CommonHeader* header,
 }
 
 void RtcpReceiver::ParseBye(rtcp::CommonHeader* header,
-                            PacketInformation* info) {
-  std::unique_ptr<rtcp::Bye> bye_packet = std::make_unique<rtcp::Bye>();
-  std::unique_ptr<Result> result = bye_packet->StorePacket(*header);
-  if (!(result->ok())) {
+                            PacketInformation* info, Arena* arena) {
+  rtcp::Bye* bye_packet = arena->New<rtcp::Bye>();
+  Status result = bye_packet->StorePacket(*header);
+  if (!(result.ok())) {
     QOSRTP_LOG(Error, "Failed to parse bye, because: %s",
-               result->description().c_str());
+               result.description());
     return;
   }
   if (config_->remote_ssrc != bye_packet->sender_ssrc()) {
@@ -199,12 +217,12 @@ void RtcpReceiver::ParseBye(rtcp::CommonHeader* header,
 }
 
 void RtcpReceiver::ParseNacks(rtcp::CommonHeader* header,
-                              PacketInformation* info) {
-  std::unique_ptr<rtcp::Nack> nack_packet = std::make_unique<rtcp::Nack>();
-  std::unique_ptr<Result> result = nack_packet->StorePacket(*header);
-  if (!(result->ok())) {
+                              PacketInformation* info, Arena* arena) {
+  rtcp::Nack* nack_packet = arena->New<rtcp::Nack>();
+  Status result = nack_packet->StorePacket(*header);
+  if (!(result.ok())) {
     QOSRTP_LOG(Error, "Failed to parse nack, because: %s",
-               result->description().c_str());
+               result.description());
     return;
   }
   if (config_->remote_ssrc != nack_packet->sender_ssrc()) {
@@ -218,6 +236,68 @@ void RtcpReceiver::ParseNacks(rtcp::CommonHeader* header,
   return;
 }
 
+void RtcpReceiver::ParsePli(rtcp::CommonHeader* header,
+                            PacketInformation* info, Arena* arena) {
+  rtcp::Pli* pli_packet = arena->New<rtcp::Pli>();
+  Status result = pli_packet->StorePacket(*header);
+  if (!(result.ok())) {
+    QOSRTP_LOG(Error, "Failed to parse pli, because: %s",
+               result.description());
+    return;
+  }
+  if ((config_->remote_ssrc != pli_packet->sender_ssrc()) ||
+      (config_->local_ssrc != pli_packet->media_ssrc())) {
+    QOSRTP_LOG(Error,
+               "Failed to parse pli, because: the ssrcs in the package do "
+               "not match this session");
+    return;
+  }
+  info->type_flags |= static_cast<uint32_t>(RTCPPacketType::kRtcpPli);
+  receiver_callback_->NotifyPliReceived();
+  return;
+}
+
+void RtcpReceiver::ParseExtendedReports(rtcp::CommonHeader* header,
+                                        PacketInformation* info,
+                                        Arena* arena) {
+  rtcp::ExtendedReports* xr_packet = arena->New<rtcp::ExtendedReports>();
+  Status result = xr_packet->StorePacket(*header);
+  if (!(result.ok())) {
+    QOSRTP_LOG(Error, "Failed to parse extended reports, because: %s",
+               result.description());
+    return;
+  }
+  if (config_->remote_ssrc != xr_packet->sender_ssrc()) {
+    QOSRTP_LOG(Error,
+               "Failed to parse extended reports, because: the ssrc in the "
+               "package is not equal to the remote ssrc");
+    return;
+  }
+  info->type_flags |= static_cast<uint32_t>(RTCPPacketType::kRtcpXr);
+  for (const auto& item : xr_packet->dlrr_items()) {
+    if (config_->local_ssrc == item.ssrc) {
+      UpdateRtt(item.last_rr, item.delay_since_last_rr);
+    }
+  }
+  if (xr_packet->has_rrtr()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    has_received_rrtr_ = true;
+    ntp_last_rrtr_ = xr_packet->rrtr_ntp();
+    ms_receive_last_rrtr_ = UTCTimeMillis();
+  }
+  return;
+}
+
+void RtcpReceiver::UpdateRtt(uint32_t last_report,
+                             uint32_t delay_since_last_report) {
+  // 0 means the remote has not received a report from us yet.
+  if (0 == last_report) return;
+  uint32_t rtt_compact_ntp = CompactNtp(NtpTime(NtpTimeNow())) -
+                             last_report - delay_since_last_report;
+  receiver_callback_->NotifyRttUpdated(
+      static_cast<uint32_t>(CompactNtpIntervalToMs(rtt_compact_ntp)));
+}
+
 void RtcpReceiver::GetSrInfo(uint32_t& lsr, uint32_t& dlsr) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (!has_received_sender_report_) {
@@ -228,4 +308,14 @@ void RtcpReceiver::GetSrInfo(uint32_t& lsr, uint32_t& dlsr) {
   lsr = (((uint64_t)ntp_last_sender_report_) << 16) >> 32;
   dlsr = ((UTCTimeMillis() - ms_receive_last_sr_) << 16) / 1000;
 }
+
+bool RtcpReceiver::GetRrtrInfo(uint32_t& lrr, uint32_t& dlrr) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!has_received_rrtr_) {
+    return false;
+  }
+  lrr = CompactNtp(ntp_last_rrtr_);
+  dlrr = ((UTCTimeMillis() - ms_receive_last_rrtr_) << 16) / 1000;
+  return true;
+}
 }  // namespace qosrtp
\ No newline at end of file
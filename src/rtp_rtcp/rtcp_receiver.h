@@ -8,12 +8,16 @@
 #include "./sdes.h"
 #include "./bye.h"
 #include "./nack.h"
+#include "./pli.h"
+#include "./xr.h"
 
 namespace qosrtp {
 class RtcpReceiverCallback {
  public:
   virtual void NotifyByeReceived() = 0;
   virtual void NotifyNackReceived(const std::vector<uint16_t>& packet_seqs) = 0;
+  virtual void NotifyPliReceived() = 0;
+  virtual void NotifyRttUpdated(uint32_t rtt_ms) = 0;
 
  protected:
   RtcpReceiverCallback();
@@ -35,8 +39,11 @@ class RtcpReceiver : public RtcpRouterDst {
   std::unique_ptr<Result> Initialize(
       RtcpReceiverCallback* receiver_callback,
       std::unique_ptr<RtcpReceiverConfig> config);
-  virtual void OnRtcpPacket(const DataBuffer* data_buffer) override;
+  virtual void OnRtcpPacket(const DataBuffer* data_buffer,
+                            Arena* arena) override;
   void GetSrInfo(uint32_t& lsr, uint32_t& dlsr);
+  // Returns false if no rrtr has been received.
+  bool GetRrtrInfo(uint32_t& lrr, uint32_t& dlrr);
 
  private:
   enum class RTCPPacketType : uint32_t {
@@ -46,18 +53,34 @@ class RtcpReceiver : public RtcpRouterDst {
     kRtcpSdes = 0x0008,
     kRtcpBye = 0x0010,
     kRtcpNack = 0x0020,
+    kRtcpXr = 0x0040,
+    kRtcpPli = 0x0080,
   };
   struct PacketInformation {
     PacketInformation();
     ~PacketInformation();
     uint32_t type_flags;
   };
-  std::unique_ptr<PacketInformation> Parse(const DataBuffer* data_buffer);
-  void ParseSenderReport(rtcp::CommonHeader* header, PacketInformation* info);
-  void ParseReceiverReport(rtcp::CommonHeader* header, PacketInformation* info);
-  void ParseSdes(rtcp::CommonHeader* header, PacketInformation* info);
-  void ParseBye(rtcp::CommonHeader* header, PacketInformation* info);
-  void ParseNacks(rtcp::CommonHeader* header, PacketInformation* info);
+  // The returned information and all the packets parsed on the way are
+  // allocated from arena.
+  PacketInformation* Parse(const DataBuffer* data_buffer, Arena* arena);
+  void ParseSenderReport(rtcp::CommonHeader* header, PacketInformation* info,
+                         Arena* arena);
+  void ParseReceiverReport(rtcp::CommonHeader* header, PacketInformation* info,
+                           Arena* arena);
+  void ParseSdes(rtcp::CommonHeader* header, PacketInformation* info,
+                 Arena* arena);
+  void ParseBye(rtcp::CommonHeader* header, PacketInformation* info,
+                Arena* arena);
+  void ParseNacks(rtcp::CommonHeader* header, PacketInformation* info,
+                  Arena* arena);
+  void ParsePli(rtcp::CommonHeader* header, PacketInformation* info,
+                Arena* arena);
+  void ParseExtendedReports(rtcp::CommonHeader* header,
+                            PacketInformation* info, Arena* arena);
+  // The round trip time is the time now minus the time the remote received
+  // our report (last_report) minus the time it held it (delay).
+  void UpdateRtt(uint32_t last_report, uint32_t delay_since_last_report);
   std::unique_ptr<RtcpReceiverConfig> config_;
   RtcpReceiverCallback* receiver_callback_;
   bool has_received_bye_;
@@ -65,5 +88,8 @@ class RtcpReceiver : public RtcpRouterDst {
   bool has_received_sender_report_;
   NtpTime ntp_last_sender_report_;
   uint64_t ms_receive_last_sr_;
+  bool has_received_rrtr_;
+  NtpTime ntp_last_rrtr_;
+  uint64_t ms_receive_last_rrtr_;
 };
 }  // namespace qosrtp
\ No newline at end of file
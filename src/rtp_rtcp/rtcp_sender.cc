@@ -10,6 +10,8 @@
 #include "./sdes.h"
 #include "./bye.h"
 #include "./nack.h"
+#include "./pli.h"
+#include "./xr.h"
 
 namespace qosrtp {
 RtcpSenderConfig::RtcpSenderConfig() {
@@ -109,6 +111,18 @@ void RtcpSender::SendNack(const std::vector<uint16_t>& nack_packet_seqs) {
   utc_ms_next_send_ = UTCTimeMillis() + config_->rtcp_report_interval_ms;
 }
 
+void RtcpSender::SendPli() {
+  SendRtcpInfo send_rtcp_info;
+  send_rtcp_info.pli = true;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (has_sent_bye_ || sender_callback_->HasReceivedBye()) {
+    return;
+  }
+  QOSRTP_LOG(Trace, "Send pli");
+  SendRtcp(&send_rtcp_info);
+  utc_ms_next_send_ = UTCTimeMillis() + config_->rtcp_report_interval_ms;
+}
+
 void RtcpSender::ScheduleSendRtcp() {
   uint64_t utc_ms_now = UTCTimeMillis();
   std::lock_guard<std::mutex> lock(mutex_);
@@ -129,7 +143,8 @@ void RtcpSender::ScheduleSendRtcp() {
   return;
 }
 
-RtcpSender::SendRtcpInfo::SendRtcpInfo() : bye(false), nack(nullptr) {}
+RtcpSender::SendRtcpInfo::SendRtcpInfo()
+    : bye(false), pli(false), nack(nullptr) {}
 
 RtcpSender::SendRtcpInfo::~SendRtcpInfo() = default;
 
@@ -203,6 +218,25 @@ void RtcpSender::SendRtcp(SendRtcpInfo* send_rtcp_info) {
   std::unique_ptr<rtcp::Sdes> sdes_packet = std::make_unique<rtcp::Sdes>();
   sdes_packet->AddCName(config_->local_ssrc, config_->local_cname);
   rtcp_packets.push_back(std::move(sdes_packet));
+  // Without sender reports the remote cannot answer with LSR/DLSR, the rrtr
+  // lets it answer with a dlrr so that the round trip time can be measured.
+  std::unique_ptr<rtcp::ExtendedReports> xr_packet = nullptr;
+  if (!b_sr) {
+    xr_packet = std::make_unique<rtcp::ExtendedReports>();
+    xr_packet->SetRrtr(NtpTime(NtpTimeNow()));
+  }
+  uint32_t lrr = 0;
+  uint32_t dlrr = 0;
+  if (sender_callback_->GetRemoteRrtrInfo(lrr, dlrr)) {
+    if (nullptr == xr_packet) {
+      xr_packet = std::make_unique<rtcp::ExtendedReports>();
+    }
+    xr_packet->AddDlrrItem({config_->remote_ssrc, lrr, dlrr});
+  }
+  if (nullptr != xr_packet) {
+    xr_packet->SetSenderSsrc(config_->local_ssrc);
+    rtcp_packets.push_back(std::move(xr_packet));
+  }
   bool is_bye = false;
   if (send_rtcp_info) {
     if (send_rtcp_info->bye) {
@@ -217,6 +251,12 @@ void RtcpSender::SendRtcp(SendRtcpInfo* send_rtcp_info) {
       nack_packet->SetPacketIds(send_rtcp_info->nack->seqs);
       rtcp_packets.push_back(std::move(nack_packet));
     }
+    if (!is_bye && send_rtcp_info->pli) {
+      std::unique_ptr<rtcp::Pli> pli_packet = std::make_unique<rtcp::Pli>();
+      pli_packet->SetSenderSsrc(config_->local_ssrc);
+      pli_packet->SetMediaSsrc(config_->remote_ssrc);
+      rtcp_packets.push_back(std::move(pli_packet));
+    }
   }
   tranceiver_->SendRtcp(std::move(rtcp_packets), is_bye);
   has_sent_rtcp_ = true;
@@ -34,6 +34,8 @@ class RtcpSenderCallback {
   virtual bool HasReceivedBye() = 0;
   virtual std::unique_ptr<RemoteSenderInfo> GetRemoteSenderInfo() = 0;
   virtual std::unique_ptr<LocalSenderInfo> GetLocalSenderInfo() = 0;
+  // Returns false if the remote has not sent an rrtr.
+  virtual bool GetRemoteRrtrInfo(uint32_t& lrr, uint32_t& dlrr) = 0;
  protected:
   RtcpSenderCallback();
   ~RtcpSenderCallback();
@@ -60,12 +62,15 @@ class RtcpSender {
                                      std::unique_ptr<RtcpSenderConfig> config);
   void SendBye();
   void SendNack(const std::vector<uint16_t>& nack_packet_seqs);
+  // Asks the remote sender for a key frame.
+  void SendPli();
 
  private:
   struct SendRtcpInfo {
     SendRtcpInfo();
     ~SendRtcpInfo();
     bool bye;
+    bool pli;
     struct NackInfo {
       NackInfo() = delete;
       NackInfo(const std::vector<uint16_t>& seqs_para);
@@ -8,7 +8,8 @@ std::unique_ptr<RtpPacket> RtpPacket::Create() {
 }
 
 std::unique_ptr<RtpPacket> RtpPacket::Create(const RtpPacket* other) {
-  std::unique_ptr<RtpPacket> packet_return = std::make_unique<RtpPacketImpl>();
+  std::unique_ptr<RtpPacketImpl> packet_return =
+      std::make_unique<RtpPacketImpl>();
   uint8_t m_payload_type_octet = other->payload_type();
   m_payload_type_octet |= other->m() ? 0x80 : 0x00;
   std::vector<uint32_t> csrcs;
@@ -33,19 +34,33 @@ std::unique_ptr<RtpPacket> RtpPacket::Create(const RtpPacket* other) {
         0, extension_src->content->Get(),
         extension_copy->content->size());
   }
+  // The copy carries the payload header in its payload buffer.
+  const RtpPacketImpl* other_impl = dynamic_cast<const RtpPacketImpl*>(other);
+  uint8_t payload_header_size =
+      (nullptr != other_impl) ? other_impl->payload_header_size() : 0;
   std::unique_ptr<DataBuffer> payload_buffer_copy =
-      other->GetPayloadBuffer()
-          ? DataBuffer::Create(other->GetPayloadBuffer()->size())
+      (other->GetPayloadBuffer() || (payload_header_size > 0))
+          ? DataBuffer::Create(
+                payload_header_size +
+                (other->GetPayloadBuffer() ? other->GetPayloadBuffer()->size()
+                                           : 0))
           : nullptr;
   if (payload_buffer_copy) {
     payload_buffer_copy->SetSize(payload_buffer_copy->capacity());
-    payload_buffer_copy->ModifyAt(0, other->GetPayloadBuffer()->Get(),
-                                  other->GetPayloadBuffer()->size());
+    if (payload_header_size > 0) {
+      payload_buffer_copy->ModifyAt(0, other_impl->payload_header(),
+                                    payload_header_size);
+    }
+    if (other->GetPayloadBuffer()) {
+      payload_buffer_copy->ModifyAt(payload_header_size,
+                                    other->GetPayloadBuffer()->Get(),
+                                    other->GetPayloadBuffer()->size());
+    }
   }
-  packet_return->StorePacket(m_payload_type_octet, other->sequence_number(),
-                             other->timestamp(), other->ssrc(), csrcs,
-                             std::move(extension_copy),
-                             std::move(payload_buffer_copy), other->pad_size());
+  packet_return->Store(m_payload_type_octet, other->sequence_number(),
+                       other->timestamp(), other->ssrc(), csrcs,
+                       std::move(extension_copy),
+                       std::move(payload_buffer_copy), other->pad_size());
   return packet_return;
 }
 
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "../include/rtp_packet.h"
+#include "../utils/status.h"
 /*
   Rtp buffer
     0                   1                   2                   3
@@ -28,7 +29,10 @@
    |                             ....                              |
 */
 namespace qosrtp {
-class RtpPacketImpl : public RtpPacket {
+// Inside the library packets are handled through this final type where
+// possible, which lets the accessors below be inlined instead of going
+// through the exported virtual interface.
+class RtpPacketImpl final : public RtpPacket {
  public:
   RtpPacketImpl() {
     octet_m_and_payload_type_ = 0;
@@ -37,9 +41,11 @@ class RtpPacketImpl : public RtpPacket {
     ssrc_ = 0;
     extension_ = nullptr;
     payload_buffer_ = nullptr;
+    payload_header_size_ = 0;
     pad_size_ = 0;
   }
   virtual ~RtpPacketImpl();
+  // The exported overloads only adapt the result of Store.
   virtual std::unique_ptr<Result> StorePacket(const uint8_t* packet,
                                               uint32_t length) override;
   virtual std::unique_ptr<Result> StorePacket(
@@ -47,23 +53,62 @@ class RtpPacketImpl : public RtpPacket {
       uint32_t timestamp, uint32_t ssrc, const std::vector<uint32_t>& csrcs,
       std::unique_ptr<Extension> extension,
       std::unique_ptr<DataBuffer> payload_buffer, uint8_t pad_size) override;
+  // Used by the library itself, no allocation is made for the status.
+  Status Store(const uint8_t* packet, uint32_t length);
+  Status Store(uint8_t octet_m_and_payload_type, uint16_t sequence_number,
+               uint32_t timestamp, uint32_t ssrc,
+               const std::vector<uint32_t>& csrcs,
+               std::unique_ptr<Extension> extension,
+               std::unique_ptr<DataBuffer> payload_buffer, uint8_t pad_size);
   virtual void SetTimestamp(uint32_t timestamp) override;
   virtual void SetSequenceNumber(uint16_t seq) override;
 
   virtual std::unique_ptr<DataBuffer> LoadPacket() const override;
-  virtual bool p() const override;
-  virtual bool x() const override;
-  virtual uint8_t count_csrcs() const override;
-  virtual uint8_t m() const override;
-  virtual uint8_t payload_type() const override;
-  virtual uint16_t sequence_number() const override;
-  virtual uint32_t timestamp() const override;
-  virtual uint32_t ssrc() const override;
+  virtual bool p() const override { return (pad_size_ > 0); }
+  virtual bool x() const override { return (extension_ != nullptr); }
+  virtual uint8_t count_csrcs() const override {
+    return static_cast<uint8_t>(csrcs_.size());
+  }
+  virtual uint8_t m() const override {
+    return (octet_m_and_payload_type_ >> kBitsizePayloadType);
+  }
+  virtual uint8_t payload_type() const override {
+    return ((((uint8_t)0xff) >> (8 - kBitsizePayloadType)) &
+            octet_m_and_payload_type_);
+  }
+  virtual uint16_t sequence_number() const override {
+    return sequence_number_;
+  }
+  virtual uint32_t timestamp() const override { return timestamp_; }
+  virtual uint32_t ssrc() const override { return ssrc_; }
   virtual std::unique_ptr<Result> csrc(uint8_t& csrc,
                                        uint8_t index) const override;
-  virtual const Extension* GetExtension() const override;
-  virtual const DataBuffer* GetPayloadBuffer() const override;
-  virtual uint8_t pad_size() const override;
+  const std::vector<uint32_t>& csrcs() const { return csrcs_; }
+  virtual const Extension* GetExtension() const override {
+    return extension_.get();
+  }
+  virtual const DataBuffer* GetPayloadBuffer() const override {
+    return payload_buffer_.get();
+  }
+  // Sent between the header and the payload buffer, e.g. the FU indicator
+  // and FU header of the H.264 fragments made by RtpPacketizer, whose
+  // payload buffers are slices of the frame. Empty otherwise.
+  uint8_t payload_header_size() const { return payload_header_size_; }
+  const uint8_t* payload_header() const { return payload_header_; }
+  // At most kMaxPayloadHeaderSize bytes.
+  bool SetPayloadHeader(const uint8_t* header, uint8_t size);
+  // The payload header of packet, empty if the application implemented the
+  // packet itself. Kept out of the exported RtpPacket, only the packets made
+  // inside the library carry one.
+  static uint8_t PayloadHeaderSize(const RtpPacket& packet) {
+    const RtpPacketImpl* packet_impl =
+        dynamic_cast<const RtpPacketImpl*>(&packet);
+    return (nullptr != packet_impl) ? packet_impl->payload_header_size_ : 0;
+  }
+  virtual uint8_t pad_size() const override { return pad_size_; }
+  // Size of the buffer returned by LoadPacket.
+  uint32_t PacketSize() const;
+  static constexpr uint8_t kMaxPayloadHeaderSize = 2;
 
  private:
   uint8_t octet_m_and_payload_type_;
@@ -73,6 +118,8 @@ class RtpPacketImpl : public RtpPacket {
   std::vector<uint32_t> csrcs_;
   std::unique_ptr<Extension> extension_;
   std::unique_ptr<DataBuffer> payload_buffer_;
+  uint8_t payload_header_[kMaxPayloadHeaderSize];
+  uint8_t payload_header_size_;
   uint8_t pad_size_;
 };
 }  // namespace qosrtp
\ No newline at end of file
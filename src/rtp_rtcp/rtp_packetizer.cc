@@ -0,0 +1,139 @@
+#include "./rtp_packetizer.h"
+#include "../utils/data_buffer_slice.h"
+#include "./rtp_packet_impl.h"
+
+namespace qosrtp {
+Status RtpPacketizer::Packetize(
+    RtpPacketization packetization, std::shared_ptr<const DataBuffer> frame,
+    uint8_t payload_type, uint32_t ssrc, uint16_t max_packet_size,
+    std::vector<std::unique_ptr<RtpPacket>>& packets) {
+  if ((nullptr == frame) || (0 == frame->size())) {
+    return Status::Error("The frame is empty");
+  }
+  if (max_packet_size <= RtpPacket::kFixedBufferLength + kH264FuAHeaderSize) {
+    return Status::Error("The mtu is too small");
+  }
+  uint32_t max_payload_size = max_packet_size - RtpPacket::kFixedBufferLength;
+  switch (packetization) {
+    case RtpPacketization::kGeneric: {
+      uint32_t nb_packets =
+          (frame->size() + max_payload_size - 1) / max_payload_size;
+      uint32_t offset = 0;
+      for (uint32_t i = 0; i < nb_packets; ++i) {
+        uint32_t size = PieceSize(frame->size(), nb_packets, i);
+        Status status = AddPacket(frame, offset, size, nullptr, 0,
+                                  payload_type, ssrc, i + 1 == nb_packets,
+                                  packets);
+        if (!status.ok()) return status;
+        offset += size;
+      }
+      return Status::Ok();
+    }
+    case RtpPacketization::kH264:
+      return PacketizeH264(frame, max_payload_size, payload_type, ssrc,
+                           packets);
+    case RtpPacketization::kOpus:
+      // RFC 7587 leaves the marker bit to the start of a talkspurt, which is
+      // not known here.
+      if (frame->size() > max_payload_size) {
+        return Status::Error("An Opus packet cannot be fragmented");
+      }
+      return AddPacket(frame, 0, frame->size(), nullptr, 0, payload_type,
+                       ssrc, false, packets);
+  }
+  return Status::Error("Unknown packetization");
+}
+
+bool RtpPacketizer::FindNalUnits(const uint8_t* data, uint32_t size,
+                                 std::vector<NalUnit>& nal_units) {
+  uint32_t pos = 0;
+  bool in_nal_unit = false;
+  while (pos + 3 <= size) {
+    if ((0x00 != data[pos]) || (0x00 != data[pos + 1]) ||
+        (0x01 != data[pos + 2])) {
+      // No NAL unit may come before the first start code.
+      if (!in_nal_unit && (0x00 != data[pos])) return false;
+      ++pos;
+      continue;
+    }
+    if (in_nal_unit) EndNalUnit(data, pos, nal_units.back());
+    pos += 3;
+    nal_units.push_back({pos, 0});
+    in_nal_unit = true;
+  }
+  if (!in_nal_unit) return false;
+  EndNalUnit(data, size, nal_units.back());
+  for (const NalUnit& nal_unit : nal_units) {
+    if (0 == nal_unit.size) return false;
+  }
+  return true;
+}
+
+void RtpPacketizer::EndNalUnit(const uint8_t* data, uint32_t end,
+                               NalUnit& nal_unit) {
+  // A NAL unit never ends with a zero byte, these belong to a 4-byte start
+  // code or are trailing_zero_8bits.
+  while ((end > nal_unit.offset) && (0x00 == data[end - 1])) --end;
+  nal_unit.size = end - nal_unit.offset;
+}
+
+Status RtpPacketizer::PacketizeH264(
+    const std::shared_ptr<const DataBuffer>& frame, uint32_t max_payload_size,
+    uint8_t payload_type, uint32_t ssrc,
+    std::vector<std::unique_ptr<RtpPacket>>& packets) {
+  std::vector<NalUnit> nal_units;
+  if (!FindNalUnits(frame->Get(), frame->size(), nal_units)) {
+    return Status::Error("The frame is not an Annex-B access unit");
+  }
+  for (size_t i = 0; i < nal_units.size(); ++i) {
+    const NalUnit& nal_unit = nal_units[i];
+    bool last_nal_unit = (i + 1 == nal_units.size());
+    if (nal_unit.size <= max_payload_size) {
+      Status status =
+          AddPacket(frame, nal_unit.offset, nal_unit.size, nullptr, 0,
+                    payload_type, ssrc, last_nal_unit, packets);
+      if (!status.ok()) return status;
+      continue;
+    }
+    // FU-A, the NAL unit header is carried by the FU indicator and header.
+    uint8_t nal_header = *(frame->At(nal_unit.offset));
+    uint32_t fragmented_size = nal_unit.size - 1;
+    uint32_t max_fragment_size = max_payload_size - kH264FuAHeaderSize;
+    uint32_t nb_fragments =
+        (fragmented_size + max_fragment_size - 1) / max_fragment_size;
+    uint32_t offset = nal_unit.offset + 1;
+    for (uint32_t j = 0; j < nb_fragments; ++j) {
+      uint32_t size = PieceSize(fragmented_size, nb_fragments, j);
+      bool last_fragment = (j + 1 == nb_fragments);
+      uint8_t fu_header[kH264FuAHeaderSize];
+      fu_header[0] = (nal_header & ~kH264NalTypeMask) | kH264FuAType;
+      fu_header[1] = nal_header & kH264NalTypeMask;
+      if (0 == j) fu_header[1] |= kH264FuStartBit;
+      if (last_fragment) fu_header[1] |= kH264FuEndBit;
+      Status status =
+          AddPacket(frame, offset, size, fu_header, kH264FuAHeaderSize,
+                    payload_type, ssrc, last_nal_unit && last_fragment,
+                    packets);
+      if (!status.ok()) return status;
+      offset += size;
+    }
+  }
+  return Status::Ok();
+}
+
+Status RtpPacketizer::AddPacket(
+    const std::shared_ptr<const DataBuffer>& frame, uint32_t offset,
+    uint32_t size, const uint8_t* payload_header, uint8_t payload_header_size,
+    uint8_t payload_type, uint32_t ssrc, bool marker,
+    std::vector<std::unique_ptr<RtpPacket>>& packets) {
+  std::unique_ptr<RtpPacketImpl> packet = std::make_unique<RtpPacketImpl>();
+  std::vector<uint32_t> csrcs;
+  Status status = packet->Store(
+      payload_type | (marker ? 0x80 : 0x00), 0, 0, ssrc, csrcs, nullptr,
+      std::make_unique<DataBufferSlice>(frame, offset, size), 0);
+  if (!status.ok()) return status;
+  packet->SetPayloadHeader(payload_header, payload_header_size);
+  packets.push_back(std::move(packet));
+  return Status::Ok();
+}
+}  // namespace qosrtp
\ No newline at end of file
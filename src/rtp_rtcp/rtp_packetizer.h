@@ -0,0 +1,55 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "../include/qosrtp_session.h"
+#include "../utils/status.h"
+
+namespace qosrtp {
+// Cuts a frame into rtp packets of at most max_packet_size bytes, header
+// included. The payloads are slices of the frame, which lives as long as the
+// packets, only the FU indicator and FU header of an H.264 fragment are
+// written on their own, as its payload header. The marker bit is set on the
+// last packet of a video frame, the sequence numbers and the timestamp are
+// left to the rtp sender.
+class RtpPacketizer {
+ public:
+  static Status Packetize(RtpPacketization packetization,
+                          std::shared_ptr<const DataBuffer> frame,
+                          uint8_t payload_type, uint32_t ssrc,
+                          uint16_t max_packet_size,
+                          std::vector<std::unique_ptr<RtpPacket>>& packets);
+
+ private:
+  // RFC 6184 section 5.8.
+  static constexpr uint8_t kH264FuAType = 28;
+  static constexpr uint8_t kH264FuAHeaderSize = 2;
+  static constexpr uint8_t kH264NalTypeMask = 0x1F;
+  static constexpr uint8_t kH264FuStartBit = 0x80;
+  static constexpr uint8_t kH264FuEndBit = 0x40;
+  struct NalUnit {
+    uint32_t offset;
+    uint32_t size;
+  };
+  // The NAL units of an Annex-B stream without their start codes.
+  static bool FindNalUnits(const uint8_t* data, uint32_t size,
+                           std::vector<NalUnit>& nal_units);
+  static void EndNalUnit(const uint8_t* data, uint32_t end,
+                         NalUnit& nal_unit);
+  static Status PacketizeH264(const std::shared_ptr<const DataBuffer>& frame,
+                              uint32_t max_payload_size, uint8_t payload_type,
+                              uint32_t ssrc,
+                              std::vector<std::unique_ptr<RtpPacket>>& packets);
+  // The size of the index-th of nb_pieces about equal pieces of size bytes.
+  static uint32_t PieceSize(uint32_t size, uint32_t nb_pieces,
+                            uint32_t index) {
+    return size / nb_pieces + ((index < size % nb_pieces) ? 1 : 0);
+  }
+  static Status AddPacket(const std::shared_ptr<const DataBuffer>& frame,
+                          uint32_t offset, uint32_t size,
+                          const uint8_t* payload_header,
+                          uint8_t payload_header_size, uint8_t payload_type,
+                          uint32_t ssrc, bool marker,
+                          std::vector<std::unique_ptr<RtpPacket>>& packets);
+};
+}  // namespace qosrtp
\ No newline at end of file
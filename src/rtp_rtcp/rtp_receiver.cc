@@ -1,12 +1,16 @@
 #include "rtp_receiver.h"
 
-#include <limits>
+#include <intrin.h>
+
 #include <algorithm>
+#include <limits>
 
 #include "../include/log.h"
 #include "../utils/byte_io.h"
 #include "../utils/seq_comparison.h"
 #include "../utils/time_utils.h"
+#include "./h26x_depacketizer.h"
+#include "./rtp_packet_impl.h"
 
 #ifdef max
 #undef max
@@ -23,44 +27,132 @@ RtpReceiverConfig::RtpReceiverConfig() {
   rtx_ssrc = 0;
   rtx_enabled = false;
   max_cache_duration_ms = 0;
+  min_target_delay_ms = 0;
+  max_target_delay_ms = 0;
+  expected_bitrate_bps = 0;
+  max_cache_bytes = 0;
+  frame_assembly_enabled = false;
+  video_codec = RtpVideoCodec::kNone;
+  catch_up_threshold_ms = 0;
   rtp_clock_rate_hz = 1;
-  max_cache_duration_ms = 0;
 }
 
 RtpReceiverConfig::~RtpReceiverConfig() = default;
 
-RtpReceiverPacketCache::CachedRTPPacket::CachedRTPPacket(
-    std::unique_ptr<RtpPacket> param_packet,
-    uint64_t param_packet_timeout_time_utc_ms)
-    : packet(std::move(param_packet)),
-      packet_timeout_time_utc_ms(param_packet_timeout_time_utc_ms) {}
-
-RtpReceiverPacketCache::CachedRTPPacket::~CachedRTPPacket() = default;
-
-RtpReceiverPacketCache::LossPacketSequenceNumber::LossPacketSequenceNumber(
-    uint16_t param_seq)
-    : seq(param_seq), notified(false), last_notify_time_utc_ms(0) {}
-
-RtpReceiverPacketCache::LossPacketSequenceNumber::~LossPacketSequenceNumber() =
-    default;
-
-RtpReceiverPacketCache::RtpReceiverPacketCache(uint16_t max_cache_duration_ms)
-    : max_cache_duration_ms_(max_cache_duration_ms),
+RtpReceiverPacketCache::RtpReceiverPacketCache(uint16_t min_delay_ms,
+                                               uint16_t max_delay_ms,
+                                               uint32_t expected_bitrate_bps,
+                                               uint32_t max_bytes)
+    : capacity_(CalculateCapacity(max_delay_ms, expected_bitrate_bps)),
+      mask_(capacity_ - 1),
+      max_bytes_((0 != max_bytes)
+                     ? max_bytes
+                     : CalculateMaxBytes(max_delay_ms, expected_bitrate_bps)),
+      cached_bytes_(0),
+      nb_evicted_frames_(0),
+      nb_evicted_packets_(0),
+      nb_evicted_bytes_(0),
+      nb_early_released_packets_(0),
+      slots_(capacity_),
+      occupancy_(capacity_ / 64, 0),
+      evicted_(capacity_ / 64, 0),
+      window_begin_seq_(0),
+      highest_seq_(-1),
+      loss_tracker_(capacity_),
+      target_delay_(min_delay_ms, max_delay_ms),
       latest_callback_seq_(0),
       has_callback_packet_(false),
       cumulative_packets_Loss_(0),
-      extended_first_seq_(0),
       extended_highest_seq_(0),
+      extended_first_seq_(0),
       has_cached_packet_(false) {}
 
 RtpReceiverPacketCache::~RtpReceiverPacketCache() = default;
 
-void RtpReceiverPacketCache::PutPacket(std::unique_ptr<RtpPacket> packet) {
+uint32_t RtpReceiverPacketCache::CalculateCapacity(
+    uint16_t max_delay_ms, uint32_t expected_bitrate_bps) {
+  if (0 == expected_bitrate_bps) {
+    expected_bitrate_bps = kDefaultExpectedBitrateBps;
+  }
+  // Twice the packets expected in max_delay_ms, which leaves room for
+  // reordering and for retransmissions that arrive late.
+  uint64_t nb_packets = 2 * static_cast<uint64_t>(expected_bitrate_bps) *
+                        max_delay_ms /
+                        (8 * 1000 * kAssumedPacketSizeBytes);
+  uint32_t capacity = kMinCapacity;
+  while ((capacity < nb_packets) && (capacity < kMaxCapacity)) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+uint32_t RtpReceiverPacketCache::CalculateMaxBytes(
+    uint16_t max_delay_ms, uint32_t expected_bitrate_bps) {
+  if (0 == expected_bitrate_bps) {
+    expected_bitrate_bps = kDefaultExpectedBitrateBps;
+  }
+  uint64_t max_bytes = static_cast<uint64_t>(kBudgetFactor) *
+                       expected_bitrate_bps * max_delay_ms / (8 * 1000);
+  return static_cast<uint32_t>(std::min<uint64_t>(
+      std::max<uint64_t>(max_bytes, kMinMaxBytes),
+      std::numeric_limits<uint32_t>::max()));
+}
+
+uint32_t RtpReceiverPacketCache::PacketSize(const RtpPacket& packet) {
+  uint32_t size = RtpPacket::kFixedBufferLength + 4 * packet.count_csrcs() +
+                  packet.pad_size();
+  const RtpPacket::Extension* extension = packet.GetExtension();
+  if (nullptr != extension) {
+    size += 4 + 4 * extension->length;
+  }
+  const DataBuffer* payload = packet.GetPayloadBuffer();
+  if (nullptr != payload) {
+    size += payload->size();
+  }
+  return size;
+}
+
+bool RtpReceiverPacketCache::IsCached(int64_t unwrapped_seq) const {
+  if ((unwrapped_seq < window_begin_seq_) || (unwrapped_seq > highest_seq_)) {
+    return false;
+  }
+  uint32_t slot = static_cast<uint32_t>(unwrapped_seq) & mask_;
+  return (occupancy_[slot >> 6] >> (slot & 63)) & 1;
+}
+
+bool RtpReceiverPacketCache::IsEvicted(int64_t unwrapped_seq) const {
+  if ((unwrapped_seq < window_begin_seq_) || (unwrapped_seq > highest_seq_)) {
+    return false;
+  }
+  uint32_t slot = static_cast<uint32_t>(unwrapped_seq) & mask_;
+  return (evicted_[slot >> 6] >> (slot & 63)) & 1;
+}
+
+int64_t RtpReceiverPacketCache::FindCachedSeq(int64_t from, int64_t to) const {
+  int64_t seq = from;
+  while (seq <= to) {
+    uint32_t slot = static_cast<uint32_t>(seq) & mask_;
+    uint64_t word = occupancy_[slot >> 6] >> (slot & 63);
+    if (0 != word) {
+      unsigned long index = 0;
+      _BitScanForward64(&index, word);
+      seq += index;
+      return (seq <= to) ? seq : (to + 1);
+    }
+    seq += 64 - (slot & 63);
+  }
+  return to + 1;
+}
+
+void RtpReceiverPacketCache::PutPacket(std::unique_ptr<RtpPacket> packet,
+                                       bool retransmitted) {
   uint16_t packet_seq = packet->sequence_number();
+  int64_t unwrapped_seq = seq_unwrapper_.Unwrap(packet_seq);
   if (has_callback_packet_) {
     // It must be the rtp packet after the rtp packet that has been called
     // back
     if (!IsSeqAfter(latest_callback_seq_, packet_seq)) {
+      loss_statistics_.OnPacket(unwrapped_seq, retransmitted, true);
       return;
     }
   }
@@ -82,209 +174,285 @@ void RtpReceiverPacketCache::PutPacket(std::unique_ptr<RtpPacket> packet) {
     extended_first_seq_ = extended_highest_seq_;
   }
   uint64_t utc_ms_now = UTCTimeMillis();
-  uint64_t packet_timeout_time_utc_ms = max_cache_duration_ms_ + utc_ms_now;
-  if (cached_packets_.empty()) {
-    cached_packets_.push_front(std::make_unique<CachedRTPPacket>(
-        std::move(packet), packet_timeout_time_utc_ms));
+  int64_t reorder_distance = 0;
+  // Seqs found missing by this packet, none if loss_from > loss_to.
+  int64_t loss_from = 0;
+  int64_t loss_to = -1;
+  // 0 if the seqs are given up with this packet.
+  uint64_t loss_deadline_utc_ms = 0;
+  if (!has_cached_packet_) {
+    window_begin_seq_ = unwrapped_seq;
+    highest_seq_ = unwrapped_seq;
+    has_cached_packet_ = true;
+  } else if (unwrapped_seq > highest_seq_) {
+    if (unwrapped_seq - window_begin_seq_ >= capacity_) {
+      QOSRTP_LOG(Warning,
+                 "Receive packet cache is full, release packets before seq: "
+                 "%hu",
+                 packet_seq);
+      ReleasePackets(unwrapped_seq - capacity_, overflow_packets_);
+    }
+    loss_from = std::max(highest_seq_ + 1, window_begin_seq_);
+    loss_to = unwrapped_seq - 1;
+    highest_seq_ = unwrapped_seq;
+  } else if (unwrapped_seq < window_begin_seq_) {
+    // Only possible before the first callback, the packet is older than
+    // every cached one.
+    if (has_callback_packet_ || (highest_seq_ - unwrapped_seq >= capacity_)) {
+      loss_statistics_.OnPacket(unwrapped_seq, retransmitted, true);
+      return;
+    }
+    loss_from = unwrapped_seq + 1;
+    loss_to = window_begin_seq_ - 1;
+    // Given up with the oldest cached packet instead.
+    if (!timeouts_.empty()) {
+      loss_deadline_utc_ms = timeouts_.front().packet_timeout_time_utc_ms;
+    }
+    window_begin_seq_ = unwrapped_seq;
+    reorder_distance = highest_seq_ - unwrapped_seq;
   } else {
-    if (IsSeqAfter(packet_seq,
-                   cached_packets_.back()->packet->sequence_number())) {
-      cached_packets_.push_back(std::make_unique<CachedRTPPacket>(
-          std::move(packet), packet_timeout_time_utc_ms));
-    } else {
-      for (auto iter = cached_packets_.begin(); iter != cached_packets_.end();
-           iter++) {
-        if ((*iter)->packet->sequence_number() == packet_seq) break;
-        if (IsSeqAfter((*iter)->packet->sequence_number(), packet_seq)) {
-          cached_packets_.insert(
-              iter, std::make_unique<CachedRTPPacket>(
-                        std::move(packet), packet_timeout_time_utc_ms));
-          break;
-        }
-      }
+    if (IsCached(unwrapped_seq) || IsEvicted(unwrapped_seq)) {
+      loss_statistics_.OnPacket(unwrapped_seq, retransmitted, true);
+      return;
     }
-  }
-  for (auto iter_loss_seq = loss_seqs_.begin();
-       iter_loss_seq != loss_seqs_.end(); ++iter_loss_seq) {
-    if ((*iter_loss_seq)->seq == packet_seq) {
-      loss_seqs_.erase(iter_loss_seq);
+    reorder_distance = highest_seq_ - unwrapped_seq;
+    if (loss_tracker_.OnReceived(unwrapped_seq, reorder_distance,
+                                 retransmitted, utc_ms_now)) {
       QOSRTP_LOG(Trace, "Receive loss packet seq: %hu", packet_seq);
-      break;
     }
   }
-  SupplementLossSeqs();
-  has_cached_packet_ = true;
-}
-
-void RtpReceiverPacketCache::SupplementLossSeqs() {
-  auto iter_cached_packet = cached_packets_.begin();
-  uint16_t last_seq = (*iter_cached_packet)->packet->sequence_number();
-  uint16_t this_seq = (*iter_cached_packet)->packet->sequence_number();
-  ++iter_cached_packet;
-  auto iter_insert_pos = loss_seqs_.begin();
-  auto func_get_loss_seqs = [this, &iter_insert_pos](const uint16_t& last_seq,
-                                       const uint16_t& this_seq) {
-    if (this_seq < last_seq) {
-      for (uint16_t loss_seq = last_seq - 1; loss_seq > this_seq; --loss_seq) {
-        bool need_insert = true;
-        for (; iter_insert_pos != loss_seqs_.end(); ++iter_insert_pos) {
-          if (loss_seq == (*iter_insert_pos)->seq) {
-            need_insert = false;
-            break;
-          }
-          if (!IsSeqBefore(loss_seq, (*iter_insert_pos)->seq)) {
-            break;
-          }
-        }
-        if (need_insert) {
-          loss_seqs_.insert(
-              iter_insert_pos,
-              std::make_unique<LossPacketSequenceNumber>(loss_seq));
-          ++cumulative_packets_Loss_;
-        }
-      }
-    } else /*if (this_seq > last_seq)*/ {
-      for (uint16_t loss_seq = last_seq - 1; loss_seq > 0; --loss_seq) {
-        bool need_insert = true;
-        for (; iter_insert_pos != loss_seqs_.end(); ++iter_insert_pos) {
-          if (loss_seq == (*iter_insert_pos)->seq) {
-            need_insert = false;
-            break;
-          }
-          if (!IsSeqBefore(loss_seq, (*iter_insert_pos)->seq)) {
-            break;
-          }
-        }
-        if (need_insert) {
-          loss_seqs_.insert(
-              iter_insert_pos,
-              std::make_unique<LossPacketSequenceNumber>(loss_seq));
-          ++cumulative_packets_Loss_;
-        }
-      }
-      for (uint16_t loss_seq = std::numeric_limits<uint16_t>::max();
-           loss_seq > this_seq; --loss_seq) {
-        bool need_insert = true;
-        for (; iter_insert_pos != loss_seqs_.end(); ++iter_insert_pos) {
-          if (loss_seq == (*iter_insert_pos)->seq) {
-            need_insert = false;
-            break;
-          }
-          if (!IsSeqBefore(loss_seq, (*iter_insert_pos)->seq)) {
-            break;
-          }
-        }
-        if (need_insert) {
-          loss_seqs_.insert(
-              iter_insert_pos,
-              std::make_unique<LossPacketSequenceNumber>(loss_seq));
-          ++cumulative_packets_Loss_;
-        }
+  loss_statistics_.OnPacket(unwrapped_seq, retransmitted, false);
+  uint32_t slot = static_cast<uint32_t>(unwrapped_seq) & mask_;
+  cached_bytes_ += PacketSize(*packet);
+  slots_[slot] = std::move(packet);
+  occupancy_[slot >> 6] |= (uint64_t(1) << (slot & 63));
+  if (loss_from <= loss_to) {
+    target_delay_.OnLoss(utc_ms_now, loss_to - loss_from + 1);
+  }
+  // A retransmission comes about an rtt late, which the loss term of the
+  // target delay covers already.
+  if (!retransmitted) {
+    target_delay_.OnPacketArrival(utc_ms_now, reorder_distance);
+  }
+  // Kept in increasing order when the target delay shrinks, so that the
+  // timeouts can be popped from the front.
+  uint64_t packet_timeout_time_utc_ms =
+      utc_ms_now + target_delay_.target_delay_ms();
+  if (!timeouts_.empty()) {
+    packet_timeout_time_utc_ms =
+        std::max(packet_timeout_time_utc_ms,
+                 timeouts_.back().packet_timeout_time_utc_ms);
+  }
+  timeouts_.push_back({unwrapped_seq, packet_timeout_time_utc_ms});
+  if (0 == loss_deadline_utc_ms) {
+    loss_deadline_utc_ms = packet_timeout_time_utc_ms;
+  }
+  AddLossSeqs(loss_from, loss_to, utc_ms_now, loss_deadline_utc_ms);
+  if (cached_bytes_ > max_bytes_) {
+    EnforceByteBudget();
+  }
+}
+
+void RtpReceiverPacketCache::AddLossSeqs(int64_t from, int64_t to,
+                                         uint64_t utc_ms_now,
+                                         uint64_t deadline_utc_ms) {
+  if (from > to) return;
+  loss_tracker_.AddLoss(from, to, utc_ms_now, deadline_utc_ms);
+  cumulative_packets_Loss_ += static_cast<uint32_t>(to - from + 1);
+}
+
+void RtpReceiverPacketCache::ReleasePackets(
+    int64_t unwrapped_seq, std::vector<std::unique_ptr<RtpPacket>>& packets) {
+  int64_t next_seq = window_begin_seq_;
+  while (next_seq <= highest_seq_) {
+    if (!IsCached(next_seq)) {
+      // Evicted seqs are not waited for either.
+      if (IsEvicted(next_seq)) {
+        ++next_seq;
+        continue;
       }
+      if (next_seq > unwrapped_seq) break;
+      // Skip the missing packets that will not be waited for any more.
+      next_seq = FindCachedSeq(next_seq, unwrapped_seq);
+      continue;
     }
-  };
-  for (; iter_cached_packet != cached_packets_.end(); ++iter_cached_packet) {
-    this_seq = (*iter_cached_packet)->packet->sequence_number();
-    // this_seq < last_seq
-    if (!IsNextSeq(this_seq, last_seq)) {
-      func_get_loss_seqs(last_seq, this_seq);
+    packets.push_back(RemovePacket(next_seq));
+    ++next_seq;
+  }
+  next_seq = std::max(next_seq, unwrapped_seq + 1);
+  if (next_seq == window_begin_seq_) return;
+  if (next_seq - window_begin_seq_ >= capacity_) {
+    std::fill(evicted_.begin(), evicted_.end(), 0);
+  } else {
+    for (int64_t seq = window_begin_seq_; seq < next_seq; ++seq) {
+      uint32_t slot = static_cast<uint32_t>(seq) & mask_;
+      evicted_[slot >> 6] &= ~(uint64_t(1) << (slot & 63));
     }
-    last_seq = this_seq;
   }
-  this_seq = latest_callback_seq_;
-  if (has_callback_packet_ && !IsNextSeq(this_seq, last_seq)) {
-    func_get_loss_seqs(last_seq, this_seq);
+  window_begin_seq_ = next_seq;
+  loss_tracker_.RemoveBefore(window_begin_seq_);
+  latest_callback_seq_ = static_cast<uint16_t>(window_begin_seq_ - 1);
+  has_callback_packet_ = true;
+}
+
+std::unique_ptr<RtpPacket> RtpReceiverPacketCache::RemovePacket(
+    int64_t unwrapped_seq) {
+  uint32_t slot = static_cast<uint32_t>(unwrapped_seq) & mask_;
+  occupancy_[slot >> 6] &= ~(uint64_t(1) << (slot & 63));
+  cached_bytes_ -= PacketSize(*slots_[slot]);
+  return std::move(slots_[slot]);
+}
+
+void RtpReceiverPacketCache::EvictFrame(int64_t from, int64_t to) {
+  int64_t seq = FindCachedSeq(from, to);
+  while (seq <= to) {
+    std::unique_ptr<RtpPacket> packet = RemovePacket(seq);
+    ++nb_evicted_packets_;
+    nb_evicted_bytes_ += PacketSize(*packet);
+    seq = FindCachedSeq(seq + 1, to);
   }
-  if (has_callback_packet_) {
-    for (auto iter_loss_seq = loss_seqs_.begin();
-         iter_loss_seq != loss_seqs_.end();) {
-      if (!IsSeqBefore(latest_callback_seq_, (*iter_loss_seq)->seq)) {
-        iter_loss_seq = loss_seqs_.erase(iter_loss_seq);
-        continue;
+  for (seq = from; seq <= to; ++seq) {
+    uint32_t slot = static_cast<uint32_t>(seq) & mask_;
+    evicted_[slot >> 6] |= (uint64_t(1) << (slot & 63));
+  }
+  loss_tracker_.Remove(from, to);
+  ++nb_evicted_frames_;
+}
+
+void RtpReceiverPacketCache::EnforceByteBudget() {
+  // A frame is a run of packets with the same timestamp, ended by the marker
+  // bit or by the next timestamp, like in FrameAssembler. It misses a packet
+  // if a seq is missing in front of it, inside it or, without marker bit,
+  // behind it. The seqs of frames evicted before are not missing. The newest
+  // frame may still be completed and is kept.
+  bool has_frame = false;
+  bool frame_missing = false;
+  int64_t frame_begin_seq = 0;
+  uint32_t frame_timestamp = 0;
+  int64_t previous_seq = window_begin_seq_ - 1;
+  while (cached_bytes_ > max_bytes_) {
+    int64_t seq = FindCachedSeq(previous_seq + 1, highest_seq_);
+    if (seq > highest_seq_) break;
+    uint32_t slot = static_cast<uint32_t>(seq) & mask_;
+    uint32_t timestamp = slots_[slot]->timestamp();
+    bool marker = slots_[slot]->m();
+    int64_t gap_seq = previous_seq + 1;
+    while ((gap_seq < seq) && IsEvicted(gap_seq)) {
+      ++gap_seq;
+    }
+    bool continuous = (gap_seq == seq);
+    if (has_frame && (timestamp != frame_timestamp)) {
+      if (frame_missing || !continuous) {
+        EvictFrame(frame_begin_seq, previous_seq);
       }
-      ++iter_loss_seq;
+      has_frame = false;
     }
+    if (!has_frame) {
+      has_frame = true;
+      frame_missing = !continuous;
+      frame_begin_seq = previous_seq + 1;
+      frame_timestamp = timestamp;
+    } else if (!continuous) {
+      frame_missing = true;
+    }
+    previous_seq = seq;
+    if (marker) {
+      if (frame_missing) {
+        EvictFrame(frame_begin_seq, seq);
+      }
+      has_frame = false;
+    }
+  }
+  if (cached_bytes_ <= max_bytes_) return;
+  QOSRTP_LOG(Warning,
+             "Receive packet cache exceeds %u bytes, release packets early.",
+             max_bytes_);
+  while (cached_bytes_ > max_bytes_) {
+    int64_t oldest_seq = FindCachedSeq(window_begin_seq_, highest_seq_);
+    if (oldest_seq > highest_seq_) break;
+    size_t nb_packets = overflow_packets_.size();
+    ReleasePackets(oldest_seq, overflow_packets_);
+    nb_early_released_packets_ +=
+        static_cast<uint32_t>(overflow_packets_.size() - nb_packets);
   }
 }
 
 void RtpReceiverPacketCache::GetPackets(
-  std::vector<std::unique_ptr<RtpPacket>>& packets) {
-   uint64_t utc_ms_now = UTCTimeMillis();
-  auto iter_latest_ready_packet = cached_packets_.end();
-  if (has_callback_packet_) {
-    int32_t nb_ready_packet = 0;
-    auto reversed_iter_latest_ready_packet = cached_packets_.rbegin();
-    uint16_t latest_ready_seq = latest_callback_seq_;
-    for (; reversed_iter_latest_ready_packet != cached_packets_.rend();
-         ++reversed_iter_latest_ready_packet) {
-      if (!IsNextSeq(latest_ready_seq, (*reversed_iter_latest_ready_packet)
-                                           ->packet->sequence_number())) {
-        break;
-      }
-      latest_ready_seq =
-          (*reversed_iter_latest_ready_packet)->packet->sequence_number();
-      ++nb_ready_packet;
-    }
-    std::advance(iter_latest_ready_packet, -nb_ready_packet);
-  }
-   bool should_get = false;
-   for (auto iter_cached_packet = cached_packets_.begin();
-        iter_cached_packet != cached_packets_.end();) {
-     if (!should_get) {
-       if ((iter_latest_ready_packet == iter_cached_packet) ||
-           ((*iter_cached_packet)->packet_timeout_time_utc_ms <= utc_ms_now)) {
-         should_get = true;
-         latest_callback_seq_ =
-             (*iter_cached_packet)->packet->sequence_number();
-         has_callback_packet_ = true;
-       }
-     }
-     if (should_get) {
-       packets.insert(packets.begin(),
-                      std::move((*iter_cached_packet)->packet));
-       iter_cached_packet = cached_packets_.erase(iter_cached_packet);
-       continue;
-     }
-     ++iter_cached_packet;
-   }
+    std::vector<std::unique_ptr<RtpPacket>>& packets) {
+  uint64_t utc_ms_now = UTCTimeMillis();
+  for (auto& packet : overflow_packets_) {
+    packets.push_back(std::move(packet));
+  }
+  overflow_packets_.clear();
+  // Everything up to the newest timed out packet is released, the packets
+  // that directly follow the last released one are always released.
+  bool has_timed_out_packet = false;
+  int64_t release_seq = window_begin_seq_ - 1;
+  while (!timeouts_.empty() &&
+         (timeouts_.front().packet_timeout_time_utc_ms <= utc_ms_now)) {
+    release_seq = std::max(release_seq, timeouts_.front().unwrapped_seq);
+    has_timed_out_packet = true;
+    timeouts_.pop_front();
+  }
+  if (!has_callback_packet_ && !has_timed_out_packet) return;
+  ReleasePackets(release_seq, packets);
+}
+
+bool RtpReceiverPacketCache::GetNextReleaseTime(
+    uint64_t& release_time_utc_ms) {
+  if (!overflow_packets_.empty()) {
+    release_time_utc_ms = 0;
+    return true;
+  }
+  // Packets released in order before their timeout leave their entry behind.
+  while (!timeouts_.empty() &&
+         (timeouts_.front().unwrapped_seq < window_begin_seq_)) {
+    timeouts_.pop_front();
+  }
+  if (timeouts_.empty()) return false;
+  release_time_utc_ms = timeouts_.front().packet_timeout_time_utc_ms;
+  return true;
 }
 
 void RtpReceiverPacketCache::GetLossPacketSeqsForNack(
     std::vector<uint16_t>& loss_packet_seqs) {
-   uint64_t utc_ms_now = UTCTimeMillis();
-   for (auto riter_loss_seq = loss_seqs_.rbegin();
-        riter_loss_seq != loss_seqs_.rend(); ++riter_loss_seq) {
-     if (!(*riter_loss_seq)->notified) {
-       (*riter_loss_seq)->notified = true;
-       (*riter_loss_seq)->last_notify_time_utc_ms = utc_ms_now;
-       loss_packet_seqs.push_back((*riter_loss_seq)->seq);
-     } else if (((*riter_loss_seq)->last_notify_time_utc_ms +
-                 kNackIntervalMs) <= utc_ms_now) {
-       (*riter_loss_seq)->last_notify_time_utc_ms = utc_ms_now;
-       loss_packet_seqs.push_back((*riter_loss_seq)->seq);
-     }
-   }
+  loss_tracker_.GetSeqsForNack(UTCTimeMillis(), highest_seq_,
+                               loss_packet_seqs);
 }
 
 RtpReceiver::RtpReceiver()
-    : receiver_callback_(nullptr),
+    : schedule_thread_(nullptr),
+      scheduled_release_utc_ms_(0),
+      receiver_callback_(nullptr),
       config_(nullptr),
       packet_cache_(nullptr),
+      frame_assembler_(nullptr),
       has_received_(false),
+      rtt_ms_(0),
       rtp_receiver_statistics_(nullptr),
+      has_transit_(false),
+      min_transit_ms_(0),
+      previous_min_transit_ms_(0),
+      transit_window_begin_utc_ms_(0),
+      catching_up_(false),
+      last_key_frame_request_utc_ms_(0),
       nb_received_expected_(0),
       nb_received_real_(0) {}
 
 RtpReceiver::~RtpReceiver() = default;
 
 std::unique_ptr<Result> RtpReceiver::Initialize(
-    RtpReceiverCallback* receiver_callback,
+    Thread* schedule_thread, RtpReceiverCallback* receiver_callback,
     std::unique_ptr<RtpReceiverConfig> config) {
-  if ((nullptr == receiver_callback) || (nullptr == config)) {
+  if ((nullptr == schedule_thread) || (nullptr == receiver_callback) ||
+      (nullptr == config)) {
     return Result::Create(-1, "Parameter cannot be a nullptr");
   }
+  schedule_thread_ = schedule_thread;
   receiver_callback_ = receiver_callback;
   config_ = std::move(config);
+  payload_types_.Build(config_->rtp_payload_types,
+                       config_->map_rtx_payload_type);
   if (config_->rtx_enabled) {
     if (config_->rtx_max_cache_seq_difference == 0) {
       return Result::Create(
@@ -292,8 +460,19 @@ std::unique_ptr<Result> RtpReceiver::Initialize(
           "The number of caches cannot be 0 when the rtx function is enabled");
     }
   }
+  uint16_t min_delay_ms = config_->min_target_delay_ms;
+  uint16_t max_delay_ms = config_->max_target_delay_ms;
+  if (0 == max_delay_ms) {
+    min_delay_ms = config_->max_cache_duration_ms;
+    max_delay_ms = config_->max_cache_duration_ms;
+  }
   packet_cache_ = std::make_unique<RtpReceiverPacketCache>(
-      config_->max_cache_duration_ms);
+      min_delay_ms, max_delay_ms, config_->expected_bitrate_bps,
+      config_->max_cache_bytes);
+  if (config_->frame_assembly_enabled ||
+      (RtpVideoCodec::kNone != config_->video_codec)) {
+    frame_assembler_ = std::make_unique<FrameAssembler>(config_->video_codec);
+  }
   rtp_receiver_statistics_ = std::make_unique<RtpReceiverStatistics>();
   rtp_receiver_statistics_->remote_ssrc = config_->remote_ssrc;
   return Result::Create();
@@ -309,8 +488,10 @@ bool RtpReceiver::IsExpectedRemoteSsrc(uint32_t ssrc) const {
 
 void RtpReceiver::OnRtpPacket(std::unique_ptr<RtpPacket> packet) {
   uint64_t trace_1 = UTCTimeMillis();
+  bool retransmitted = false;
   if (config_->rtx_enabled) {
     if (packet->ssrc() == config_->rtx_ssrc) {
+      retransmitted = true;
       packet = ReconstructRtpFromRtx(std::move(packet));
       if (nullptr == packet) {
         QOSRTP_LOG(Error, "Failed to reconstruct rtp from rtx.");
@@ -337,10 +518,7 @@ void RtpReceiver::OnRtpPacket(std::unique_ptr<RtpPacket> packet) {
   //    return;
   //  }
   //}
-  auto iter_rtp_payload_type =
-      std::find(config_->rtp_payload_types.begin(),
-                config_->rtp_payload_types.end(), packet->payload_type());
-  if (iter_rtp_payload_type == config_->rtp_payload_types.end()) {
+  if (!payload_types_.IsMedia(m_payload_type_octet)) {
     QOSRTP_LOG(Error, "Received rtp packet with unknown payload type.");
     return;
   }
@@ -361,58 +539,241 @@ void RtpReceiver::OnRtpPacket(std::unique_ptr<RtpPacket> packet) {
   }
   interarrival_jitter_info.last_rtp_utc_ms = utc_now_ms;
   interarrival_jitter_info.last_rtp_timestamp = packet->timestamp();
-  std::vector<std::unique_ptr<RtpPacket>> packets;
+  if (0 != config_->catch_up_threshold_ms) {
+    UpdateTransit(packet->timestamp(), utc_now_ms);
+  }
   std::vector<uint16_t> loss_packet_seqs;
   uint64_t trace_2 = UTCTimeMillis();
-  packet_cache_->PutPacket(std::move(packet));
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    rtp_receiver_statistics_->first_extended_seq_num =
-        packet_cache_->extended_first_seq();
-    rtp_receiver_statistics_->extended_seq_num =
-        packet_cache_->extended_highest_seq();
-    nb_received_expected_ = rtp_receiver_statistics_->extended_seq_num -
-                            rtp_receiver_statistics_->first_extended_seq_num;
-    ++nb_received_real_;
-    int32_t cumulative_loss = nb_received_expected_ - nb_received_real_;
-    rtp_receiver_statistics_->cumulative_loss =
-        (cumulative_loss > 0) ? cumulative_loss : 0;
-    rtp_receiver_statistics_->interarrival_jitter =
-        interarrival_jitter_info.interarrival_jitter;
-  }
-  has_received_.store(true);
+  packet_cache_->PutPacket(std::move(packet), retransmitted);
+  rtp_receiver_statistics_->first_extended_seq_num =
+      packet_cache_->extended_first_seq();
+  rtp_receiver_statistics_->extended_seq_num =
+      packet_cache_->extended_highest_seq();
+  nb_received_expected_ = rtp_receiver_statistics_->extended_seq_num -
+                          rtp_receiver_statistics_->first_extended_seq_num;
+  ++nb_received_real_;
+  int32_t cumulative_loss = nb_received_expected_ - nb_received_real_;
+  rtp_receiver_statistics_->cumulative_loss =
+      (cumulative_loss > 0) ? cumulative_loss : 0;
+  rtp_receiver_statistics_->interarrival_jitter =
+      interarrival_jitter_info.interarrival_jitter;
+  rtp_receiver_statistics_->evicted_frames = packet_cache_->nb_evicted_frames();
+  rtp_receiver_statistics_->evicted_packets =
+      packet_cache_->nb_evicted_packets();
+  rtp_receiver_statistics_->evicted_bytes = packet_cache_->nb_evicted_bytes();
+  rtp_receiver_statistics_->early_released_packets =
+      packet_cache_->nb_early_released_packets();
+  rtp_receiver_statistics_->loss_pattern =
+      packet_cache_->loss_statistics().statistics();
   uint64_t trace_3 = UTCTimeMillis();
+  packet_cache_->UpdateRtt(
+      rtt_ms_.load(),
+      static_cast<uint32_t>(
+          (uint64_t)interarrival_jitter_info.interarrival_jitter * 1000 /
+          config_->rtp_clock_rate_hz));
   packet_cache_->GetLossPacketSeqsForNack(loss_packet_seqs);
+  const LossTracker& loss_tracker = packet_cache_->loss_tracker();
+  rtp_receiver_statistics_->suppressed_nacks =
+      loss_tracker.nb_suppressed_nacks();
+  rtp_receiver_statistics_->nacked_seqs = loss_tracker.nb_nacked_seqs();
+  rtp_receiver_statistics_->spurious_nacks = loss_tracker.nb_spurious_nacks();
+  statistics_snapshot_.Store(*rtp_receiver_statistics_);
+  has_received_.store(true);
   uint64_t trace_4 = UTCTimeMillis();
   receiver_callback_->NotifyLossPacketSeqsForNack(loss_packet_seqs);
   uint64_t trace_5 = UTCTimeMillis();
-  packet_cache_->GetPackets(packets);
+  DeliverPackets(utc_now_ms);
   uint64_t trace_6 = UTCTimeMillis();
-  if (packets.empty()) {
-    //QOSRTP_LOG(Trace,
-    //           "RtpReceiver::OnRtpPacket inner cost: (%lld %lld %lld %lld %lld"
-    //           ") ms",
-    //           trace_2 - trace_1, trace_3 - trace_2, trace_4 - trace_3,
-    //           trace_5 - trace_4, trace_6 - trace_5);
+  ScheduleRelease();
+  //QOSRTP_LOG(Trace,
+  //           "RtpReceiver::OnRtpPacket inner cost: (%lld %lld %lld %lld %lld"
+  //           ") ms",
+  //           trace_2 - trace_1, trace_3 - trace_2, trace_4 - trace_3,
+  //           trace_5 - trace_4, trace_6 - trace_5);
+}
+
+void RtpReceiver::DeliverPackets(uint64_t utc_ms_now) {
+  std::vector<std::unique_ptr<RtpPacket>> packets;
+  packet_cache_->GetPackets(packets);
+  if (nullptr != frame_assembler_) {
+    std::vector<std::unique_ptr<RtpFrame>> frames;
+    frame_assembler_->InsertPackets(std::move(packets), utc_ms_now, frames);
+    frame_assembler_->Flush(utc_ms_now, packet_cache_->target_delay_ms(),
+                            frames);
+    if (0 != config_->catch_up_threshold_ms) {
+      CatchUpFrames(frames, utc_ms_now);
+    }
+    if (!frames.empty()) {
+      receiver_callback_->OnRtpFrames(std::move(frames));
+    }
     return;
   }
+  if (0 != config_->catch_up_threshold_ms) {
+    CatchUpPackets(packets, utc_ms_now);
+  }
+  if (packets.empty()) return;
   receiver_callback_->OnRtpPacket(std::move(packets));
-  uint64_t trace_7 = UTCTimeMillis();
-  //QOSRTP_LOG(
-  //    Trace,
-  //    "RtpReceiver::OnRtpPacket inner cost: (%lld %lld %lld %lld %lld %lld) ms",
-  //    trace_2 - trace_1, trace_3 - trace_2, trace_4 - trace_3,
-  //    trace_5 - trace_4, trace_6 - trace_5, trace_7 - trace_6);
+}
+
+void RtpReceiver::UpdateTransit(uint32_t timestamp, uint64_t utc_ms_now) {
+  int64_t transit_ms = static_cast<int64_t>(utc_ms_now) -
+                       TimestampToMs(timestamp);
+  if (!has_transit_) {
+    has_transit_ = true;
+    min_transit_ms_ = transit_ms;
+    previous_min_transit_ms_ = transit_ms;
+    transit_window_begin_utc_ms_ = utc_ms_now;
+    return;
+  }
+  // Two windows let the minimum follow clock drift without forgetting it
+  // right after a stall.
+  if (utc_ms_now - transit_window_begin_utc_ms_ >= kTransitWindowMs) {
+    previous_min_transit_ms_ = min_transit_ms_;
+    min_transit_ms_ = transit_ms;
+    transit_window_begin_utc_ms_ = utc_ms_now;
+    return;
+  }
+  min_transit_ms_ = (std::min)(min_transit_ms_, transit_ms);
+}
+
+int64_t RtpReceiver::TimestampToMs(uint32_t timestamp) {
+  return timestamp_unwrapper_.Unwrap(timestamp) * 1000 /
+         config_->rtp_clock_rate_hz;
+}
+
+int64_t RtpReceiver::DeliveryLag(uint32_t timestamp, uint64_t utc_ms_now) {
+  if (!has_transit_) return 0;
+  return static_cast<int64_t>(utc_ms_now) - TimestampToMs(timestamp) -
+         (std::min)(min_transit_ms_, previous_min_transit_ms_);
+}
+
+bool RtpReceiver::CatchUp(uint32_t timestamp, const RtpPacket* first_packet,
+                          uint32_t nb_packets, uint64_t utc_ms_now) {
+  int64_t lag_ms = DeliveryLag(timestamp, utc_ms_now);
+  bool late = lag_ms > static_cast<int64_t>(config_->catch_up_threshold_ms);
+  if (!catching_up_) {
+    if (!late) return false;
+    catching_up_ = true;
+    last_key_frame_request_utc_ms_ = 0;
+    ++rtp_receiver_statistics_->catch_ups;
+    QOSRTP_LOG(Info,
+               "Rtp receiver is %lld ms behind, dropping until the next key "
+               "frame.",
+               lag_ms);
+  }
+  if (!late && (nullptr != first_packet) && IsKeyFrameStart(*first_packet)) {
+    catching_up_ = false;
+    QOSRTP_LOG(Info, "Rtp receiver caught up at timestamp %u.", timestamp);
+    return false;
+  }
+  rtp_receiver_statistics_->catch_up_dropped_packets += nb_packets;
+  return true;
+}
+
+bool RtpReceiver::IsKeyFrameStart(const RtpPacket& packet) {
+  if (RtpVideoCodec::kNone == config_->video_codec) {
+    return receiver_callback_->IsKeyFrameStart(packet);
+  }
+  const DataBuffer* payload = packet.GetPayloadBuffer();
+  if (nullptr == payload) return false;
+  return H26xDepacketizer::IsKeyFrameStart(config_->video_codec,
+                                           payload->Get(), payload->size());
+}
+
+void RtpReceiver::CatchUpPackets(
+    std::vector<std::unique_ptr<RtpPacket>>& packets, uint64_t utc_ms_now) {
+  if (packets.empty()) return;
+  auto iter_keep = packets.begin();
+  for (auto& packet : packets) {
+    if (CatchUp(packet->timestamp(), packet.get(), 1, utc_ms_now)) continue;
+    *iter_keep++ = std::move(packet);
+  }
+  if (iter_keep != packets.end()) {
+    packets.erase(iter_keep, packets.end());
+    statistics_snapshot_.Store(*rtp_receiver_statistics_);
+  }
+  RequestKeyFrameIfNeeded(utc_ms_now);
+}
+
+void RtpReceiver::CatchUpFrames(std::vector<std::unique_ptr<RtpFrame>>& frames,
+                                uint64_t utc_ms_now) {
+  if (frames.empty()) return;
+  auto iter_keep = frames.begin();
+  for (auto& frame : frames) {
+    const RtpPacket* first_packet = nullptr;
+    if (!frame->missing() && (frame->nb_packets() > 0)) {
+      first_packet = frame->packet(0);
+    }
+    if (CatchUp(frame->timestamp(), first_packet, frame->nb_packets(),
+                utc_ms_now)) {
+      continue;
+    }
+    *iter_keep++ = std::move(frame);
+  }
+  if (iter_keep != frames.end()) {
+    frames.erase(iter_keep, frames.end());
+    statistics_snapshot_.Store(*rtp_receiver_statistics_);
+  }
+  RequestKeyFrameIfNeeded(utc_ms_now);
+}
+
+void RtpReceiver::RequestKeyFrameIfNeeded(uint64_t utc_ms_now) {
+  if (!catching_up_) return;
+  if ((0 != last_key_frame_request_utc_ms_) &&
+      (utc_ms_now - last_key_frame_request_utc_ms_ <
+       kKeyFrameRequestIntervalMs)) {
+    return;
+  }
+  last_key_frame_request_utc_ms_ = utc_ms_now;
+  ++rtp_receiver_statistics_->key_frame_requests;
+  statistics_snapshot_.Store(*rtp_receiver_statistics_);
+  receiver_callback_->RequestKeyFrame();
+}
+
+void RtpReceiver::ScheduleRelease() {
+  uint64_t release_time_utc_ms = 0;
+  bool has_release_time =
+      packet_cache_->GetNextReleaseTime(release_time_utc_ms);
+  uint64_t flush_time_utc_ms = 0;
+  if ((nullptr != frame_assembler_) &&
+      frame_assembler_->GetFlushTime(packet_cache_->target_delay_ms(),
+                                     flush_time_utc_ms)) {
+    if (!has_release_time || (flush_time_utc_ms < release_time_utc_ms)) {
+      release_time_utc_ms = flush_time_utc_ms;
+    }
+    has_release_time = true;
+  }
+  if (!has_release_time) return;
+  if ((0 != scheduled_release_utc_ms_) &&
+      (scheduled_release_utc_ms_ <= release_time_utc_ms)) {
+    return;
+  }
+  uint64_t utc_ms_now = UTCTimeMillis();
+  // Never 0, so that 0 keeps meaning no timer is armed.
+  release_time_utc_ms = std::max(release_time_utc_ms, utc_ms_now + 1);
+  scheduled_release_utc_ms_ = release_time_utc_ms;
+  schedule_thread_->PushTask(
+      CallableWrapper::Wrap(&RtpReceiver::OnReleaseTimer, this,
+                            release_time_utc_ms),
+      release_time_utc_ms - utc_ms_now);
+}
+
+void RtpReceiver::OnReleaseTimer(uint64_t release_time_utc_ms) {
+  // A timer superseded by an earlier one.
+  if (release_time_utc_ms != scheduled_release_utc_ms_) return;
+  scheduled_release_utc_ms_ = 0;
+  DeliverPackets(UTCTimeMillis());
+  ScheduleRelease();
 }
 
 std::unique_ptr<RtpPacket> RtpReceiver::ReconstructRtpFromRtx(
     std::unique_ptr<RtpPacket> packet) {
-  auto iter = config_->map_rtx_payload_type.find(packet->payload_type());
-  if (iter == config_->map_rtx_payload_type.end()) {
+  uint8_t payload_type_reconstruct =
+      payload_types_.AssociatedPayloadType(packet->payload_type());
+  if (PayloadTypeTable::kNone == payload_type_reconstruct) {
     QOSRTP_LOG(Error, "Received rtx packet with unknown payload type.");
     return nullptr;
   }
-  uint8_t payload_type_reconstruct = iter->second;
   const DataBuffer* rtx_payload_buffer = packet->GetPayloadBuffer();
   if (nullptr == rtx_payload_buffer) {
     QOSRTP_LOG(Error, "Received rtx packet with null payload.");
@@ -455,11 +816,12 @@ std::unique_ptr<RtpPacket> RtpReceiver::ReconstructRtpFromRtx(
         0, extension_rtx->content->Get(),
         extension_reconstruct->content->size());
   }
-  std::unique_ptr<RtpPacket> packet_reconstruct = RtpPacket::Create();
-  packet_reconstruct->StorePacket(payload_type_reconstruct, seq_reconstruct,
-                                  packet->timestamp(), config_->remote_ssrc,
-                                  csrcs, std::move(extension_reconstruct),
-                                  std::move(payload_buffer_reconstruct), 0);
+  std::unique_ptr<RtpPacketImpl> packet_reconstruct =
+      std::make_unique<RtpPacketImpl>();
+  packet_reconstruct->Store(payload_type_reconstruct, seq_reconstruct,
+                            packet->timestamp(), config_->remote_ssrc, csrcs,
+                            std::move(extension_reconstruct),
+                            std::move(payload_buffer_reconstruct), 0);
 
   QOSRTP_LOG(Trace,
              "Reconstruct packet (ssrc: %u, pt: %hhu, seq: %hu), from packet "
@@ -472,6 +834,6 @@ std::unique_ptr<RtpPacket> RtpReceiver::ReconstructRtpFromRtx(
 
 std::unique_ptr<RtpReceiverStatistics> RtpReceiver::GetRtpReceiverStatistics() {
   if (!has_received_.load()) return nullptr;
-  return std::make_unique<RtpReceiverStatistics>(*rtp_receiver_statistics_);
+  return std::make_unique<RtpReceiverStatistics>(statistics_snapshot_.Load());
 }
 }  // namespace qosrtp
\ No newline at end of file
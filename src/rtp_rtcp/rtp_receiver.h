@@ -1,7 +1,14 @@
 #pragma once
-#include <list>
+#include <deque>
 #include <vector>
 
+#include "../utils/seq_comparison.h"
+#include "../utils/seqlock.h"
+#include "./frame_assembler.h"
+#include "./loss_statistics.h"
+#include "./loss_tracker.h"
+#include "./payload_type_table.h"
+#include "./target_delay_estimator.h"
 #include "rtp_rtcp_router.h"
 
 namespace qosrtp {
@@ -12,6 +19,11 @@ class RtpReceiverCallback {
       const std::vector<uint16_t>& loss_packet_seqs) = 0;
   /* use std::move */
   virtual void OnRtpPacket(std::vector<std::unique_ptr<RtpPacket>> packets) = 0;
+  /* use std::move, replaces OnRtpPacket when frame assembly is enabled */
+  virtual void OnRtpFrames(std::vector<std::unique_ptr<RtpFrame>> frames) = 0;
+  // Asked during catch-up when no video codec is configured.
+  virtual bool IsKeyFrameStart(const RtpPacket& packet) = 0;
+  virtual void RequestKeyFrame() = 0;
 
  protected:
   RtpReceiverCallback();
@@ -25,49 +37,142 @@ struct RtpReceiverConfig {
   uint32_t rtp_clock_rate_hz;
   std::vector<uint8_t> rtp_payload_types;
   uint16_t max_cache_duration_ms;
+  // Bounds of the adaptive jitter buffer delay, both 0 to hold packets for
+  // max_cache_duration_ms.
+  uint16_t min_target_delay_ms;
+  uint16_t max_target_delay_ms;
+  // Used to size the packet cache, 0 if unknown.
+  uint32_t expected_bitrate_bps;
+  // Bytes the packet cache may hold, 0 to derive it from the expected
+  // bitrate.
+  uint32_t max_cache_bytes;
   bool rtx_enabled;
   uint16_t rtx_max_cache_seq_difference;
   uint32_t rtx_ssrc;
   std::map<uint8_t, uint8_t> map_rtx_payload_type;
+  bool frame_assembly_enabled;
+  // Builds the bitstream of the assembled frames, implies frame assembly.
+  RtpVideoCodec video_codec;
+  // Delivery lag above which the receiver catches up, 0 to disable.
+  uint32_t catch_up_threshold_ms;
 };
 
+// Jitter buffer of the receiver. Packets are stored in a power-of-two ring
+// indexed by (seq & mask), with an occupancy bitmap next to it, so insert,
+// duplicate detection and in-order release do not search. The ring is sized
+// once from max_cache_duration_ms and the expected bitrate. A packet too far
+// ahead of the oldest cached one forces the packets it would overwrite out.
+// A packet is held for the adaptive target delay, within [min_delay_ms,
+// max_delay_ms], before the missing packets in front of it are given up.
+// The cached bytes are bounded too. Over the budget, the oldest frames with
+// a missing packet are dropped first, and if that is not enough the oldest
+// packets are released early.
 class RtpReceiverPacketCache {
  public:
-  RtpReceiverPacketCache(uint16_t max_cache_duration_ms);
+  // 0 for expected_bitrate_bps uses kDefaultExpectedBitrateBps, 0 for
+  // max_bytes derives the budget from the expected bitrate.
+  RtpReceiverPacketCache(uint16_t min_delay_ms, uint16_t max_delay_ms,
+                         uint32_t expected_bitrate_bps, uint32_t max_bytes);
   ~RtpReceiverPacketCache();
-  void PutPacket(std::unique_ptr<RtpPacket> packet);
+  // retransmitted is true for packets reconstructed from rtx.
+  void PutPacket(std::unique_ptr<RtpPacket> packet, bool retransmitted);
   //void PutFecPacket(std::unique_ptr<RtpPacket> packet);
   //void ReconstructPacketsFromFec();
+  // The seq of the packets "increases" with index
   void GetPackets(std::vector<std::unique_ptr<RtpPacket>>& packets);
+  // Earliest time at which GetPackets will hand out a packet that is held
+  // now, false if no packet is held.
+  bool GetNextReleaseTime(uint64_t& release_time_utc_ms);
   // seq in loss_packet_seqs "increases" with index
   void GetLossPacketSeqsForNack(std::vector<uint16_t>& loss_packet_seqs);
+  void UpdateRtt(uint32_t rtt_ms, uint32_t jitter_ms) {
+    loss_tracker_.UpdateRtt(rtt_ms, jitter_ms);
+    target_delay_.UpdateRtt(rtt_ms, jitter_ms);
+  }
+  uint16_t target_delay_ms() const { return target_delay_.target_delay_ms(); }
   //void GetLossPacketSeqs(std::vector<uint16_t>& loss_packet_seqs);
   uint32_t extended_highest_seq() { return extended_highest_seq_; }
   uint32_t cumulative_packets_Loss() { return cumulative_packets_Loss_; }
   uint32_t extended_first_seq() { return extended_first_seq_; }
+  const LossTracker& loss_tracker() const { return loss_tracker_; }
+  LossStatistics& loss_statistics() { return loss_statistics_; }
+  uint32_t capacity() const { return capacity_; }
+  uint32_t max_bytes() const { return max_bytes_; }
+  uint32_t cached_bytes() const { return cached_bytes_; }
+  uint32_t nb_evicted_frames() const { return nb_evicted_frames_; }
+  uint32_t nb_evicted_packets() const { return nb_evicted_packets_; }
+  uint64_t nb_evicted_bytes() const { return nb_evicted_bytes_; }
+  // Packets released before their deadline to stay within the budget.
+  uint32_t nb_early_released_packets() const {
+    return nb_early_released_packets_;
+  }
 
  private:
-  static const uint16_t kNackIntervalMs = 50;
-  void SupplementLossSeqs();
-  struct CachedRTPPacket {
-    CachedRTPPacket(std::unique_ptr<RtpPacket> param_packet,
-                    uint64_t param_packet_timeout_time_utc_ms);
-    ~CachedRTPPacket();
-    std::unique_ptr<RtpPacket> packet;
+  static const uint32_t kDefaultExpectedBitrateBps = 4 * 1000 * 1000;
+  // Small on purpose, audio and low bitrate video packets are well below
+  // the MTU and the ring has to hold all of them.
+  static const uint32_t kAssumedPacketSizeBytes = 500;
+  static const uint32_t kMinCapacity = 64;
+  // Half the seq space, larger rings would make seq & mask ambiguous.
+  static const uint32_t kMaxCapacity = 1 << 15;
+  // The derived budget holds that many times the bytes expected in
+  // max_delay_ms, and at least kMinMaxBytes.
+  static constexpr uint32_t kBudgetFactor = 4;
+  static constexpr uint32_t kMinMaxBytes = 256 * 1024;
+  static uint32_t CalculateMaxBytes(uint16_t max_delay_ms,
+                                    uint32_t expected_bitrate_bps);
+  static uint32_t PacketSize(const RtpPacket& packet);
+  static uint32_t CalculateCapacity(uint16_t max_delay_ms,
+                                    uint32_t expected_bitrate_bps);
+  bool IsCached(int64_t unwrapped_seq) const;
+  bool IsEvicted(int64_t unwrapped_seq) const;
+  // Returns the first cached seq in [from, to], or to + 1 if there is none.
+  int64_t FindCachedSeq(int64_t from, int64_t to) const;
+  // Hands out every cached packet up to and including unwrapped_seq, then
+  // the packets that directly follow it.
+  void ReleasePackets(int64_t unwrapped_seq,
+                      std::vector<std::unique_ptr<RtpPacket>>& packets);
+  // deadline_utc_ms is the timeout of the cached packet the missing ones are
+  // given up with.
+  void AddLossSeqs(int64_t from, int64_t to, uint64_t utc_ms_now,
+                   uint64_t deadline_utc_ms);
+  // Takes the packet out of its slot.
+  std::unique_ptr<RtpPacket> RemovePacket(int64_t unwrapped_seq);
+  // Drops the oldest frames with a missing packet, then releases the oldest
+  // packets into overflow_packets_, until cached_bytes_ fits max_bytes_.
+  void EnforceByteBudget();
+  // Drops the cached packets of [from, to] and stops nacking the seqs.
+  void EvictFrame(int64_t from, int64_t to);
+  uint32_t capacity_;
+  uint32_t mask_;
+  uint32_t max_bytes_;
+  uint32_t cached_bytes_;
+  uint32_t nb_evicted_frames_;
+  uint32_t nb_evicted_packets_;
+  uint64_t nb_evicted_bytes_;
+  uint32_t nb_early_released_packets_;
+  std::vector<std::unique_ptr<RtpPacket>> slots_;
+  // One bit per slot, set while the slot holds a packet.
+  std::vector<uint64_t> occupancy_;
+  // One bit per slot, set for the seqs of evicted frames until the window
+  // passes them. They do not make the next frame look incomplete, and their
+  // late packets are dropped.
+  std::vector<uint64_t> evicted_;
+  struct CachedPacketTimeout {
+    int64_t unwrapped_seq;
     uint64_t packet_timeout_time_utc_ms;
   };
-  // The smaller the index, the "bigger" the corresponding seq.
-  std::list<std::unique_ptr<CachedRTPPacket>> cached_packets_;
-  struct LossPacketSequenceNumber {
-    LossPacketSequenceNumber(uint16_t param_seq);
-    ~LossPacketSequenceNumber();
-    uint16_t seq;
-    bool notified;
-    uint64_t last_notify_time_utc_ms;
-  };
-  // The smaller the index, the "bigger" the corresponding seq.
-  std::list<std::unique_ptr<LossPacketSequenceNumber>> loss_seqs_;
-  uint16_t max_cache_duration_ms_;
+  // In arrival order, which is also timeout order.
+  std::deque<CachedPacketTimeout> timeouts_;
+  // Packets pushed out of the ring by PutPacket, handed out by GetPackets.
+  std::vector<std::unique_ptr<RtpPacket>> overflow_packets_;
+  SeqUnwrapper seq_unwrapper_;
+  // Oldest seq that can still be cached and highest seq cached so far.
+  int64_t window_begin_seq_;
+  int64_t highest_seq_;
+  LossTracker loss_tracker_;
+  LossStatistics loss_statistics_;
+  TargetDelayEstimator target_delay_;
   uint16_t latest_callback_seq_;
   bool has_callback_packet_;
   uint32_t cumulative_packets_Loss_;
@@ -82,6 +187,22 @@ struct RtpReceiverStatistics {
   uint32_t extended_seq_num = 0;
   uint32_t first_extended_seq_num = 0;
   uint32_t interarrival_jitter = 0;
+  // Losses not nacked because the retransmission would arrive too late.
+  uint32_t suppressed_nacks = 0;
+  uint32_t nacked_seqs = 0;
+  // Nacked seqs whose original packet arrived late instead of being lost.
+  uint32_t spurious_nacks = 0;
+  // Dropped or released early to keep the packet cache within its budget.
+  uint32_t evicted_frames = 0;
+  uint32_t evicted_packets = 0;
+  uint64_t evicted_bytes = 0;
+  uint32_t early_released_packets = 0;
+  // Times the delivery lag went over the catch-up threshold, and the packets
+  // dropped until a key frame resumed delivery.
+  uint32_t catch_ups = 0;
+  uint32_t catch_up_dropped_packets = 0;
+  uint32_t key_frame_requests = 0;
+  LossPatternStatistics loss_pattern;
 };
 
 class RtpReceiver : public RtpRouterDst {
@@ -89,10 +210,14 @@ class RtpReceiver : public RtpRouterDst {
   RtpReceiver();
   ~RtpReceiver();
   /* Call it first, otherwise it will lead to unexpected results */
-  std::unique_ptr<Result> Initialize(RtpReceiverCallback* receiver_callback,
+  // schedule_thread must be the thread OnRtpPacket is called on, held packets
+  // are released on it when their deadline passes.
+  std::unique_ptr<Result> Initialize(Thread* schedule_thread,
+                                     RtpReceiverCallback* receiver_callback,
                                      std::unique_ptr<RtpReceiverConfig> config);
   std::unique_ptr<RtpReceiverStatistics> GetRtpReceiverStatistics();
   bool HasReceivedRtp() { return has_received_.load(); }
+  void SetRtt(uint32_t rtt_ms) { rtt_ms_.store(rtt_ms); }
 
   /* RtpRouterDst override */
   virtual bool IsExpectedRemoteSsrc(uint32_t ssrc) const override;
@@ -101,12 +226,60 @@ class RtpReceiver : public RtpRouterDst {
  private:
   std::unique_ptr<RtpPacket> ReconstructRtpFromRtx(
       std::unique_ptr<RtpPacket> packet);
+  // Hands the packets or frames that are due to the callback.
+  void DeliverPackets(uint64_t utc_ms_now);
+  // Arms the release timer for the earliest deadline of the held packets and
+  // of the pending frame, unless an earlier timer is already armed.
+  void ScheduleRelease();
+  void OnReleaseTimer(uint64_t release_time_utc_ms);
+  // The arrival time minus the media time of the packet, its lowest value
+  // over the last two windows is the transit of a packet that was not held
+  // up anywhere.
+  void UpdateTransit(uint32_t timestamp, uint64_t utc_ms_now);
+  int64_t TimestampToMs(uint32_t timestamp);
+  // How much later than an unstalled packet the media with timestamp is
+  // delivered.
+  int64_t DeliveryLag(uint32_t timestamp, uint64_t utc_ms_now);
+  // Returns true if the packet or frame with timestamp has to be dropped.
+  // Once the delivery lag goes over the threshold everything is dropped
+  // until a key frame that is no longer late, first_packet is nullptr if
+  // the media cannot start a key frame.
+  bool CatchUp(uint32_t timestamp, const RtpPacket* first_packet,
+               uint32_t nb_packets, uint64_t utc_ms_now);
+  bool IsKeyFrameStart(const RtpPacket& packet);
+  void CatchUpPackets(std::vector<std::unique_ptr<RtpPacket>>& packets,
+                      uint64_t utc_ms_now);
+  void CatchUpFrames(std::vector<std::unique_ptr<RtpFrame>>& frames,
+                     uint64_t utc_ms_now);
+  // Requests a key frame when catch-up starts, then every
+  // kKeyFrameRequestIntervalMs until it ends.
+  void RequestKeyFrameIfNeeded(uint64_t utc_ms_now);
+  static constexpr uint64_t kTransitWindowMs = 10000;
+  static constexpr uint64_t kKeyFrameRequestIntervalMs = 500;
+  Thread* schedule_thread_;
+  // 0 if no release timer is armed.
+  uint64_t scheduled_release_utc_ms_;
   RtpReceiverCallback* receiver_callback_;
   std::unique_ptr<RtpReceiverConfig> config_;
+  PayloadTypeTable payload_types_;
   std::unique_ptr<RtpReceiverPacketCache> packet_cache_;
+  // nullptr if frame assembly is disabled.
+  std::unique_ptr<FrameAssembler> frame_assembler_;
   std::atomic<bool> has_received_;
-  std::mutex mutex_;
+  // 0 until the first rtt is measured.
+  std::atomic<uint32_t> rtt_ms_;
+  // Updated on the receiving thread, then published to statistics_snapshot_
+  // for GetRtpReceiverStatistics on any thread.
   std::unique_ptr<RtpReceiverStatistics> rtp_receiver_statistics_;
+  SeqLock<RtpReceiverStatistics> statistics_snapshot_;
+  TimestampUnwrapper timestamp_unwrapper_;
+  bool has_transit_;
+  int64_t min_transit_ms_;
+  int64_t previous_min_transit_ms_;
+  uint64_t transit_window_begin_utc_ms_;
+  bool catching_up_;
+  // 0 if no key frame was requested during this catch-up.
+  uint64_t last_key_frame_request_utc_ms_;
   int32_t nb_received_expected_;
   int32_t nb_received_real_;
   struct {
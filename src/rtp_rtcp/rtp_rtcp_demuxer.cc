@@ -1,5 +1,6 @@
 #include "./rtp_rtcp_demuxer.h"
 
+#include "./rtp_packet_impl.h"
 #include "./rtp_rtcp_tranceiver.h"
 #include "../include/log.h"
 
@@ -13,14 +14,14 @@ void RtpRtcpPacketDemuxer::OnData(
     std::vector<std::unique_ptr<DataBuffer>> data_buffers) {
   std::vector<std::unique_ptr<RtpPacket>> rtps;
   std::vector<std::unique_ptr<DataBuffer>> rtcps;
+  rtps.reserve(data_buffers.size());
   for (auto iter = data_buffers.begin(); iter != data_buffers.end(); ++iter) {
     std::unique_ptr<DataBuffer> data_buffer = std::move(*iter);
     if ((nullptr == data_buffer) || (nullptr == callback_)) continue;
     if (IsRtp(data_buffer.get())) {
-      std::unique_ptr<RtpPacket> packet = RtpPacket::Create();
-      std::unique_ptr<Result> result =
-          packet->StorePacket(data_buffer->Get(), data_buffer->size());
-      if (result->ok()) {
+      std::unique_ptr<RtpPacketImpl> packet = std::make_unique<RtpPacketImpl>();
+      Status result = packet->Store(data_buffer->Get(), data_buffer->size());
+      if (result.ok()) {
         //QOSRTP_LOG(Trace, "Parse rtp packet, pt: %hu, seq: %hu, ts: %u",
         //           (uint16_t)packet->payload_type(), packet->sequence_number(),
         //           packet->timestamp());
@@ -28,7 +29,7 @@ void RtpRtcpPacketDemuxer::OnData(
         //callback_->OnRtp(std::move(packet));
       } else {
         QOSRTP_LOG(Error, "Failed to parse rtp packet, because: %s",
-                   result->description().c_str());
+                   result.description());
       }
     } else if (IsRtcp(data_buffer.get())) {
       rtcps.push_back(std::move(data_buffer));
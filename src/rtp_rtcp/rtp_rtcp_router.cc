@@ -102,8 +102,9 @@ void RtpRtcpRouter::OnRtcp(
   for (auto iter = data_buffers.begin(); iter != data_buffers.end(); ++iter) {
     std::unique_ptr<DataBuffer> data_buffer = std::move(*iter);
     for (auto& dst : rtcp_destinations_) {
-      dst->OnRtcpPacket(data_buffer.get());
+      dst->OnRtcpPacket(data_buffer.get(), &batch_arena_);
     }
   }
+  batch_arena_.Reset();
 }
 }  // namespace qosrtp
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "../include/rtp_packet.h"
 #include "../include/data_buffer.h"
 #include "../include/result.h"
+#include "../utils/arena.h"
 #include "../utils/thread.h"
 #include "./rtp_rtcp_tranceiver.h"
 
@@ -22,7 +23,9 @@ class RtpRouterDst {
 
 class RtcpRouterDst {
  public:
-  virtual void OnRtcpPacket(const DataBuffer* data_buffer) = 0;
+  /* Objects created from arena only live until the end of the current receive
+   * batch. */
+  virtual void OnRtcpPacket(const DataBuffer* data_buffer, Arena* arena) = 0;
 
  protected:
   RtcpRouterDst();
@@ -54,5 +57,7 @@ class RtpRtcpRouter : public RtpRtcpTranceiverCallback {
   std::mutex mutex_destinations_;
   std::vector<RtpRouterDst*> rtp_destinations_;
   std::vector<RtcpRouterDst*> rtcp_destinations_;
+  // Only used on the worker thread, reset after each rtcp batch.
+  Arena batch_arena_;
 };
 }  // namespace qosrtp
\ No newline at end of file
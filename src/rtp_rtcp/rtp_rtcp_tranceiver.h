@@ -6,6 +6,7 @@
 #include "../include/rtp_packet.h"
 #include "../network/network_io_scheduler.h"
 #include "../utils/thread.h"
+#include "./pacer.h"
 #include "./rtcp_packet.h"
 
 namespace qosrtp {
@@ -29,7 +30,21 @@ class RtpRtcpTranceiver {
   virtual ~RtpRtcpTranceiver();
   /* Both SendRtp and SendRtcp will automatically switch to run on the
    * network_thread set in the Create. */
-  virtual void SendRtp(std::unique_ptr<RtpPacket> packet) = 0;
+  // With a pacing rate the rtp and rtx packets of all the media sessions go
+  // through one pacer, rtcp is never paced. 0 for rate_bps sends the
+  // packets right away, which is the default. With kernel_assisted the os
+  // spaces the packets out, see NetworkTranceiver::SetKernelPacingRate, and
+  // the pacer only keeps the priorities and the average rate.
+  virtual void SetPacing(uint32_t rate_bps, uint32_t burst_bytes,
+                         bool kernel_assisted) = 0;
+  // Drops the packet rather than sending it after info.deadline_us, paced
+  // or not, or once another packet of info.frame was dropped.
+  virtual void SendRtp(std::shared_ptr<const RtpPacket> packet,
+                       PacketPriority priority, PacketSendInfo info) = 0;
+  // Sends rtx_header followed by the payload of packet as one rtx packet,
+  // the payload is not copied. Paced as PacketPriority::kRtx.
+  virtual void SendRtx(std::unique_ptr<DataBuffer> rtx_header,
+                       std::shared_ptr<const RtpPacket> packet) = 0;
   virtual void SendRtcp(
       std::vector<std::unique_ptr<rtcp::RtcpPacket>> packets, bool is_bye = false) = 0;
 
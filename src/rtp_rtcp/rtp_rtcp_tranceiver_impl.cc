@@ -7,7 +7,10 @@ namespace qosrtp {
 RtpRtcpTranceiverImpl::RtpRtcpTranceiverImpl()
     : demuxer_(nullptr),
       network_tranceiver_(nullptr),
-      network_thread_(nullptr) {}
+      network_thread_(nullptr),
+      pacer_(nullptr),
+      pacer_wake_up_pending_(false),
+      kernel_pacing_(false) {}
 
 RtpRtcpTranceiverImpl::~RtpRtcpTranceiverImpl() = default;
 
@@ -34,15 +37,155 @@ std::unique_ptr<Result> RtpRtcpTranceiverImpl::InitTranceiver(
   return Result::Create();
 }
 
-void RtpRtcpTranceiverImpl::SendRtp(std::unique_ptr<RtpPacket> packet) {
+void RtpRtcpTranceiverImpl::SetPacing(uint32_t rate_bps, uint32_t burst_bytes,
+                                      bool kernel_assisted) {
   if (!network_thread_->IsCurrent()) {
-    network_thread_->PushTask(CallableWrapper::Wrap(
-        &RtpRtcpTranceiverImpl::SendRtp, this, std::move(packet)));
+    network_thread_->PushTask(
+        CallableWrapper::Wrap(&RtpRtcpTranceiverImpl::SetPacing, this,
+                              rate_bps, burst_bytes, kernel_assisted));
+    return;
+  }
+  if ((0 == rate_bps) || !kernel_assisted) {
+    if (kernel_pacing_) network_tranceiver_->SetKernelPacingRate(0);
+    kernel_pacing_ = false;
+  } else {
+    std::unique_ptr<Result> result =
+        network_tranceiver_->SetKernelPacingRate(rate_bps);
+    kernel_pacing_ = result->ok();
+    if (!kernel_pacing_) {
+      QOSRTP_LOG(Warning,
+                 "Falling back to pacing in user space, because: %s",
+                 result->description().c_str());
+    }
+  }
+  if (kernel_pacing_) {
+    // The budget gained between two wake ups must fit in the bucket.
+    uint64_t interval_bytes =
+        static_cast<uint64_t>(rate_bps) * kKernelPacingIntervalMs / 8000;
+    if (0 == burst_bytes) burst_bytes = RtpPacer::kDefaultBurstBytes;
+    if (interval_bytes > burst_bytes) {
+      burst_bytes = static_cast<uint32_t>(interval_bytes);
+    }
+  }
+  if (0 == rate_bps) {
+    if (nullptr == pacer_) return;
+    std::vector<PacedPacket> queued_packets;
+    pacer_->TakeAll(queued_packets);
+    pacer_.reset(nullptr);
+    for (const PacedPacket& packet : queued_packets) {
+      SendToNetwork(packet);
+    }
+    return;
+  }
+  if (nullptr == pacer_) {
+    pacer_ =
+        std::make_unique<RtpPacer>(rate_bps, burst_bytes, SteadyTimeMicros());
+    return;
+  }
+  pacer_->SetRate(rate_bps, burst_bytes, SteadyTimeMicros());
+  ProcessPacer();
+}
+
+void RtpRtcpTranceiverImpl::SendRtp(std::shared_ptr<const RtpPacket> packet,
+                                    PacketPriority priority,
+                                    PacketSendInfo info) {
+  if (!network_thread_->IsCurrent()) {
+    network_thread_->PushTask(
+        CallableWrapper::Wrap(&RtpRtcpTranceiverImpl::SendRtp, this,
+                              std::move(packet), priority, std::move(info)));
     return;
   }
   if (nullptr == packet) return;
-  std::unique_ptr<DataBuffer> data_buffer = packet->LoadPacket();
-  network_tranceiver_->Send(std::move(data_buffer));
+  PacedPacket paced_packet;
+  paced_packet.info = std::move(info);
+  // Late in the task queue of the network thread already, or a packet of
+  // the frame was dropped before it.
+  uint64_t time_us_now = SteadyTimeMicros();
+  if (paced_packet.IsDropped(time_us_now)) {
+    RtpPacer::Drop(paced_packet, paced_packet.IsExpired(time_us_now));
+    return;
+  }
+  paced_packet.data = packet->LoadPacket();
+  if (nullptr == paced_packet.data) return;
+  paced_packet.size = paced_packet.data->size();
+  SendPaced(priority, std::move(paced_packet));
+}
+
+void RtpRtcpTranceiverImpl::SendRtx(std::unique_ptr<DataBuffer> rtx_header,
+                                    std::shared_ptr<const RtpPacket> packet) {
+  if (!network_thread_->IsCurrent()) {
+    network_thread_->PushTask(CallableWrapper::Wrap(
+        &RtpRtcpTranceiverImpl::SendRtx, this, std::move(rtx_header),
+        std::move(packet)));
+    return;
+  }
+  if ((nullptr == rtx_header) || (nullptr == packet)) return;
+  PacedPacket paced_packet;
+  paced_packet.size = rtx_header->size();
+  const DataBuffer* payload = packet->GetPayloadBuffer();
+  if (nullptr != payload) paced_packet.size += payload->size();
+  paced_packet.data = std::move(rtx_header);
+  paced_packet.payload_of = std::move(packet);
+  SendPaced(PacketPriority::kRtx, std::move(paced_packet));
+}
+
+void RtpRtcpTranceiverImpl::SendPaced(PacketPriority priority,
+                                      PacedPacket packet) {
+  if (nullptr == pacer_) {
+    SendToNetwork(packet);
+    return;
+  }
+  pacer_->Enqueue(priority, std::move(packet), SteadyTimeMicros());
+  ProcessPacer();
+}
+
+void RtpRtcpTranceiverImpl::ProcessPacer() {
+  uint64_t time_us_now = SteadyTimeMicros();
+  PacedPacket packet;
+  while (pacer_->Dequeue(time_us_now, &packet)) {
+    SendToNetwork(packet);
+  }
+  if (pacer_wake_up_pending_) return;
+  uint64_t wait_duration_us = pacer_->TimeUntilNextSendUs(time_us_now);
+  if (RtpPacer::kNoPacketQueued == wait_duration_us) return;
+  // Delayed tasks run with millisecond precision, the budget gained in the
+  // extra time is spent in the next burst so the average rate holds.
+  uint64_t wait_duration_ms =
+      (wait_duration_us + kNumMicrosecsPerMillisec - 1) /
+      kNumMicrosecsPerMillisec;
+  // The os spaces the packets out, so the queued budget is handed over in
+  // larger bursts and the thread wakes up less often.
+  if (kernel_pacing_ && (wait_duration_ms < kKernelPacingIntervalMs)) {
+    wait_duration_ms = kKernelPacingIntervalMs;
+  }
+  pacer_wake_up_pending_ = true;
+  network_thread_->PushTask(
+      CallableWrapper::Wrap(&RtpRtcpTranceiverImpl::OnPacerWakeUp, this),
+      wait_duration_ms);
+}
+
+void RtpRtcpTranceiverImpl::OnPacerWakeUp() {
+  pacer_wake_up_pending_ = false;
+  if (nullptr == pacer_) return;
+  ProcessPacer();
+}
+
+void RtpRtcpTranceiverImpl::SendToNetwork(const PacedPacket& packet) {
+  if (nullptr == packet.data) return;
+  NetworkSendBuffer buffers[2];
+  uint32_t nb_buffers = 0;
+  buffers[nb_buffers++] = {packet.data->Get(), packet.data->size()};
+  if (nullptr != packet.payload_of) {
+    const DataBuffer* payload = packet.payload_of->GetPayloadBuffer();
+    if ((nullptr != payload) && (0 != payload->size())) {
+      buffers[nb_buffers++] = {payload->Get(), payload->size()};
+    }
+  }
+  network_tranceiver_->Send(buffers, nb_buffers);
+  if (nullptr != packet.info.statistics) {
+    packet.info.statistics->AddQueueDelay(SteadyTimeMicros() -
+                                          packet.info.enqueue_time_us);
+  }
 }
 
 void RtpRtcpTranceiverImpl::SendRtcp(
@@ -67,16 +210,16 @@ void RtpRtcpTranceiverImpl::SendRtcp(
   compound_packet_buffer->SetSize(compound_packet_size);
   uint32_t write_pos = 0;
   uint8_t* buffer_inner = compound_packet_buffer->GetW();
-  std::unique_ptr<Result> load_result = nullptr;
+  Status load_result;
   for (auto iter = packets.begin(); iter != packets.end(); iter++) {
     if (nullptr == (*iter)) {
       continue;
     }
     load_result =
         (*iter)->LoadPacket(buffer_inner, &write_pos, compound_packet_size);
-    if (!load_result->ok()) {
+    if (!load_result.ok()) {
       QOSRTP_LOG(Error, "Failed to load rtcp packet, because: %s",
-                 load_result->description().c_str());
+                 load_result.description());
       return;
     }
   }
@@ -9,7 +9,13 @@ class RtpRtcpTranceiverImpl : public RtpRtcpTranceiver {
   RtpRtcpTranceiverImpl();
   virtual ~RtpRtcpTranceiverImpl() override;
 
-  virtual void SendRtp(std::unique_ptr<RtpPacket> packet) override;
+  virtual void SetPacing(uint32_t rate_bps, uint32_t burst_bytes,
+                         bool kernel_assisted) override;
+  virtual void SendRtp(std::shared_ptr<const RtpPacket> packet,
+                       PacketPriority priority,
+                       PacketSendInfo info) override;
+  virtual void SendRtx(std::unique_ptr<DataBuffer> rtx_header,
+                       std::shared_ptr<const RtpPacket> packet) override;
   virtual void SendRtcp(std::vector<std::unique_ptr<rtcp::RtcpPacket>> packets,
                         bool is_bye) override;
 
@@ -18,8 +24,19 @@ class RtpRtcpTranceiverImpl : public RtpRtcpTranceiver {
       RtpRtcpTranceiverCallback* callback, Thread* network_thread,
       NetworkIoScheduler* scheduler, TransportAddress* local_address,
       TransportAddress* remote_address) override;
+  // How often the pacer hands a burst to the os with kernel pacing.
+  static constexpr uint64_t kKernelPacingIntervalMs = 10;
+  void SendPaced(PacketPriority priority, PacedPacket packet);
+  // Sends what the budget of the pacer allows and wakes up again when the
+  // next packet is due.
+  void ProcessPacer();
+  void OnPacerWakeUp();
+  void SendToNetwork(const PacedPacket& packet);
   std::unique_ptr<RtpRtcpPacketDemuxer> demuxer_;
   std::unique_ptr<NetworkTranceiver> network_tranceiver_;
   Thread* network_thread_;
+  std::unique_ptr<RtpPacer> pacer_;
+  bool pacer_wake_up_pending_;
+  bool kernel_pacing_;
 };
 }  // namespace qosrtp
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "../utils/byte_io.h"
 #include "../utils/seq_comparison.h"
 #include "../utils/time_utils.h"
+#include "./rtp_packet_impl.h"
+#include "./ulp_fec.h"
 
 #include <random>
 #include <algorithm>
@@ -14,10 +16,16 @@
 namespace qosrtp {
 RtpSenderConfig::RtpSenderConfig() {
   max_cache_seq_difference = 0;
+  min_history_duration_ms = 0;
+  max_history_bytes = 0;
   local_ssrc = 0;
   rtx_ssrc = 0;
   rtx_enabled = false;
+  max_rtx_bitrate_percent = 0;
   rtp_clock_rate_hz = 1;
+  media_priority = PacketPriority::kVideo;
+  fec_payload_type = -1;
+  auto_sequencing = false;
 }
 
 RtpSenderConfig::~RtpSenderConfig() = default;
@@ -26,38 +34,241 @@ RtpSenderCallback::RtpSenderCallback() = default;
 
 RtpSenderCallback::~RtpSenderCallback() = default;
 
-RtpSenderPacketCache::RtpSenderPacketCache(uint16_t max_cache_seq_difference)
-    : max_cache_seq_difference_(max_cache_seq_difference) {}
+RtpSenderPacketCache::RtpSenderPacketCache(uint16_t initial_nb_packets,
+                                           uint16_t min_duration_ms,
+                                           uint32_t max_bytes)
+    : slots_(CalculateCapacity(initial_nb_packets)),
+      mask_(static_cast<uint32_t>(slots_.size()) - 1),
+      min_duration_ms_((0 != min_duration_ms) ? min_duration_ms
+                                              : kDefaultMinDurationMs),
+      max_bytes_((0 != max_bytes) ? max_bytes : kDefaultMaxBytes),
+      rtt_ms_(0),
+      nb_packets_(0),
+      cached_bytes_(0),
+      nb_hits_(0),
+      nb_misses_(0),
+      nb_suppressed_(0),
+      nb_expired_(0),
+      nb_dropped_(0),
+      oldest_seq_(0),
+      newest_seq_(0) {}
 
 RtpSenderPacketCache::~RtpSenderPacketCache() = default;
 
-void RtpSenderPacketCache::PutPacket(std::unique_ptr<RtpPacket> packet) {
-  for (auto iter_cached_packet = cached_rtp_packets_.begin();
-       iter_cached_packet != cached_rtp_packets_.end();) {
-    if (IsSeqBeforeInRange((*iter_cached_packet)->sequence_number(),
-                           packet->sequence_number(),
-                           max_cache_seq_difference_)) {
+uint32_t RtpSenderPacketCache::CalculateCapacity(uint16_t nb_packets) {
+  uint32_t capacity = kMinCapacity;
+  while ((capacity < kMaxCapacity) &&
+         (capacity <= static_cast<uint32_t>(nb_packets))) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+uint32_t RtpSenderPacketCache::PacketSize(const RtpPacket& packet) {
+  uint32_t size = RtpPacket::kFixedBufferLength + 4 * packet.count_csrcs() +
+                  RtpPacketImpl::PayloadHeaderSize(packet) +
+                  packet.pad_size();
+  const RtpPacket::Extension* extension = packet.GetExtension();
+  if (nullptr != extension) {
+    size += 4 + 4 * extension->length;
+  }
+  const DataBuffer* payload = packet.GetPayloadBuffer();
+  if (nullptr != payload) {
+    size += payload->size();
+  }
+  return size;
+}
+
+uint32_t RtpSenderPacketCache::duration_ms() const {
+  uint32_t rtt_ms = (0 != rtt_ms_) ? rtt_ms_ : kDefaultRttMs;
+  return (std::max)(kRttFactor * rtt_ms,
+                    static_cast<uint32_t>(min_duration_ms_));
+}
+
+bool RtpSenderPacketCache::Grow() {
+  uint32_t capacity = static_cast<uint32_t>(slots_.size());
+  if (capacity >= kMaxCapacity) return false;
+  std::vector<CachedPacket> slots(capacity << 1);
+  uint32_t mask = (capacity << 1) - 1;
+  if (0 != nb_packets_) {
+    for (int64_t seq = oldest_seq_; seq <= newest_seq_; ++seq) {
+      slots[seq & mask] = std::move(slots_[seq & mask_]);
+    }
+  }
+  slots_ = std::move(slots);
+  mask_ = mask;
+  return true;
+}
+
+void RtpSenderPacketCache::RemoveOldest() {
+  CachedPacket& oldest = slots_[oldest_seq_ & mask_];
+  cached_bytes_ -= oldest.size;
+  --nb_packets_;
+  oldest = CachedPacket();
+  if (0 == nb_packets_) return;
+  // Packets of payload types without rtx leave holes.
+  do {
+    ++oldest_seq_;
+  } while (nullptr == slots_[oldest_seq_ & mask_].packet);
+}
+
+void RtpSenderPacketCache::Evict(uint64_t utc_ms_now) {
+  uint32_t duration = duration_ms();
+  while (nb_packets_ > 1) {
+    const CachedPacket& oldest = slots_[oldest_seq_ & mask_];
+    if ((cached_bytes_ <= max_bytes_) &&
+        (utc_ms_now - oldest.send_time_utc_ms <= duration)) {
       break;
     }
-    iter_cached_packet = cached_rtp_packets_.erase(iter_cached_packet);
+    RemoveOldest();
   }
-  cached_rtp_packets_.push_back(std::move(packet));
 }
 
-void RtpSenderPacketCache::GetPackets(
-    const std::vector<uint16_t>& packet_seqs,
-    std::vector<std::unique_ptr<RtpPacket>>& out_packets) {
-  for (auto iter_seq = packet_seqs.begin(); iter_seq != packet_seqs.end();
-       ++iter_seq) {
-    for (auto iter_cached_packet = cached_rtp_packets_.begin();
-         iter_cached_packet != cached_rtp_packets_.end();
-         ++iter_cached_packet) {
-      if ((*iter_cached_packet)->sequence_number() == (*iter_seq)) {
-        out_packets.push_back(RtpPacket::Create((*iter_cached_packet).get()));
-        break;
-      }
+void RtpSenderPacketCache::PutPacket(
+    std::shared_ptr<const RtpPacket> packet, uint64_t utc_ms_now,
+    uint64_t deadline_utc_ms, std::shared_ptr<const SendFrameState> frame) {
+  int64_t seq = seq_unwrapper_.Unwrap(packet->sequence_number());
+  if ((0 != nb_packets_) && (seq <= newest_seq_)) return;
+  if (0 == nb_packets_) {
+    oldest_seq_ = seq;
+  }
+  while ((seq - oldest_seq_) > static_cast<int64_t>(mask_)) {
+    if (Grow()) continue;
+    RemoveOldest();
+    if (0 == nb_packets_) {
+      oldest_seq_ = seq;
     }
   }
+  CachedPacket& slot = slots_[seq & mask_];
+  slot.size = PacketSize(*packet);
+  slot.send_time_utc_ms = utc_ms_now;
+  slot.deadline_utc_ms = deadline_utc_ms;
+  slot.frame = std::move(frame);
+  slot.packet = std::move(packet);
+  cached_bytes_ += slot.size;
+  ++nb_packets_;
+  newest_seq_ = seq;
+  Evict(utc_ms_now);
+}
+
+RtpSenderPacketCache::CachedPacket* RtpSenderPacketCache::Find(uint16_t seq) {
+  if (0 == nb_packets_) return nullptr;
+  // Nacked seqs are behind the newest one, unwrapped next to it.
+  int64_t unwrapped_seq =
+      newest_seq_ + static_cast<int16_t>(static_cast<uint16_t>(
+                        seq - static_cast<uint16_t>(newest_seq_)));
+  if ((unwrapped_seq < oldest_seq_) || (unwrapped_seq > newest_seq_)) {
+    return nullptr;
+  }
+  CachedPacket& slot = slots_[unwrapped_seq & mask_];
+  return (nullptr != slot.packet) ? &slot : nullptr;
+}
+
+std::shared_ptr<const RtpPacket> RtpSenderPacketCache::GetPacket(
+    uint16_t seq, uint64_t utc_ms_now) {
+  CachedPacket* cached_packet = Find(seq);
+  if (nullptr == cached_packet) {
+    ++nb_misses_;
+    return nullptr;
+  }
+  ++nb_hits_;
+  if ((0 != cached_packet->deadline_utc_ms) &&
+      (utc_ms_now > cached_packet->deadline_utc_ms)) {
+    ++nb_expired_;
+    return nullptr;
+  }
+  // The receiver cannot use the rest of the frame.
+  if ((nullptr != cached_packet->frame) &&
+      cached_packet->frame->dropped.load()) {
+    ++nb_dropped_;
+    return nullptr;
+  }
+  uint32_t interval_ms =
+      (0 != rtt_ms_) ? rtt_ms_ : kDefaultRetransmitIntervalMs;
+  if ((0 != cached_packet->retransmit_time_utc_ms) &&
+      (utc_ms_now - cached_packet->retransmit_time_utc_ms < interval_ms)) {
+    ++nb_suppressed_;
+    return nullptr;
+  }
+  return cached_packet->packet;
+}
+
+void RtpSenderPacketCache::OnRetransmitted(uint16_t seq,
+                                           uint64_t utc_ms_now) {
+  CachedPacket* cached_packet = Find(seq);
+  if (nullptr != cached_packet) {
+    cached_packet->retransmit_time_utc_ms = utc_ms_now;
+  }
+}
+
+RtxRateLimiter::RtxRateLimiter(uint16_t max_percent)
+    : max_percent_(max_percent),
+      slot_bytes_(),
+      slot_index_(0),
+      slot_start_utc_ms_(0),
+      first_utc_ms_(0),
+      has_media_(false),
+      window_bytes_(0),
+      budget_millibits_(0),
+      budget_update_utc_ms_(0) {}
+
+RtxRateLimiter::~RtxRateLimiter() = default;
+
+void RtxRateLimiter::Advance(uint64_t utc_ms_now) {
+  if (utc_ms_now - slot_start_utc_ms_ >= kWindowMs + kSlotMs) {
+    slot_bytes_.fill(0);
+    window_bytes_ = 0;
+    slot_start_utc_ms_ = utc_ms_now;
+    return;
+  }
+  while (utc_ms_now - slot_start_utc_ms_ >= kSlotMs) {
+    slot_index_ = (slot_index_ + 1) % kNbSlots;
+    window_bytes_ -= slot_bytes_[slot_index_];
+    slot_bytes_[slot_index_] = 0;
+    slot_start_utc_ms_ += kSlotMs;
+  }
+}
+
+void RtxRateLimiter::OnMediaSent(uint32_t size, uint64_t utc_ms_now) {
+  if (!has_media_) {
+    has_media_ = true;
+    first_utc_ms_ = utc_ms_now;
+    slot_start_utc_ms_ = utc_ms_now;
+    budget_update_utc_ms_ = utc_ms_now;
+  }
+  Advance(utc_ms_now);
+  slot_bytes_[slot_index_] += size;
+  window_bytes_ += size;
+}
+
+uint32_t RtxRateLimiter::media_bitrate_bps() const {
+  if (!has_media_) return 0;
+  // Shorter at first, the window is not full yet.
+  uint64_t window_ms =
+      std::min<uint64_t>(kWindowMs, slot_start_utc_ms_ + kSlotMs -
+                                        first_utc_ms_);
+  return static_cast<uint32_t>(static_cast<uint64_t>(window_bytes_) * 8 *
+                               1000 / window_ms);
+}
+
+bool RtxRateLimiter::TryRetransmit(uint32_t size, uint64_t utc_ms_now) {
+  if (0 == max_percent_) return true;
+  if (!has_media_) return false;
+  Advance(utc_ms_now);
+  int64_t rtx_bitrate_bps =
+      static_cast<int64_t>(media_bitrate_bps()) * max_percent_ / 100;
+  if (utc_ms_now > budget_update_utc_ms_) {
+    budget_millibits_ +=
+        rtx_bitrate_bps *
+        static_cast<int64_t>(utc_ms_now - budget_update_utc_ms_);
+    budget_update_utc_ms_ = utc_ms_now;
+  }
+  budget_millibits_ =
+      std::min(budget_millibits_, rtx_bitrate_bps * kMaxBurstMs);
+  int64_t cost_millibits = static_cast<int64_t>(size) * 8 * 1000;
+  if (budget_millibits_ < cost_millibits) return false;
+  budget_millibits_ -= cost_millibits;
+  return true;
 }
 
 RtpSender::RtpSender()
@@ -66,13 +277,21 @@ RtpSender::RtpSender()
       tranceiver_(nullptr),
       config_(nullptr),
       cache_(nullptr),
+      rtx_rate_limiter_(nullptr),
+      rtx_packets_(0),
+      rtx_bytes_(0),
+      rtx_rate_limited_(0),
+      frames_dropped_expired_(0),
+      send_queue_statistics_(std::make_shared<SendQueueStatistics>()),
       has_sent_(false),
       last_seq_(0),
       utc_ms_first_(0),
       rtp_timestamp_first_(0),
       rtp_clock_rate_(0),
       sender_packet_count_(0),
-      sender_octet_count_(0) {}
+      sender_octet_count_(0),
+      first_capture_time_utc_ms_(0),
+      first_capture_timestamp_(0) {}
 
 RtpSender::~RtpSender() = default;
 
@@ -93,6 +312,8 @@ std::unique_ptr<Result> RtpSender::Initialize(
   sender_callback = sender_callback;
   tranceiver_ = tranceiver;
   config_ = std::move(config);
+  payload_types_.Build(config_->rtp_payload_types,
+                       config_->map_rtx_payload_type);
   if (config_->rtx_enabled) {
     if (config_->max_cache_seq_difference == 0) {
       return Result::Create(
@@ -100,31 +321,27 @@ std::unique_ptr<Result> RtpSender::Initialize(
           "The number of caches cannot be 0 when the rtx function is enabled");
     }
     cache_ = std::make_unique<RtpSenderPacketCache>(
-        config_->max_cache_seq_difference);
+        config_->max_cache_seq_difference, config_->min_history_duration_ms,
+        config_->max_history_bytes);
+    rtx_rate_limiter_ =
+        std::make_unique<RtxRateLimiter>(config_->max_rtx_bitrate_percent);
   }
   return Result::Create();
 }
 
 void RtpSender::SendRtp(std::unique_ptr<RtpPacket> packet) {
   if (nullptr == packet) return;
-  if (config_->local_ssrc != packet->ssrc()) {
-    QOSRTP_LOG(
-        Error,
-        "The ssrc (%u) of the rtp packet given to RtpSender does not match "
-        "the set ssrc(%u)",
-        packet->ssrc(), config_->local_ssrc);
-    return;
-  }
-  uint8_t m_payload_type_octet = packet->payload_type();
-  auto iter_rtp_clock_rate = std::find(config_->rtp_payload_types.begin(),
-                config_->rtp_payload_types.end(), packet->payload_type());
-  if (iter_rtp_clock_rate == config_->rtp_payload_types.end()) {
-    QOSRTP_LOG(Error,
-               "The payload_type (%u) of the rtp packet given to RtpSender "
-               "does not match the set payload_type",
-               packet->payload_type());
+  if (config_->auto_sequencing) {
+    std::vector<std::unique_ptr<RtpPacket>> packets;
+    packets.push_back(std::move(packet));
+    SendRtpPackets(std::move(packets), UTCTimeMillis(), FrameSendOptions(),
+                   SteadyTimeMicros());
     return;
   }
+  if (!IsValidRtp(*packet)) return;
+  PacketSendInfo info;
+  info.enqueue_time_us = SteadyTimeMicros();
+  info.statistics = send_queue_statistics_;
   //if (config_->rtx_enabled) {
   //  auto iter_rtx_type =
   //      std::find_if(config_->map_rtx_payload_type.begin(),
@@ -141,6 +358,170 @@ void RtpSender::SendRtp(std::unique_ptr<RtpPacket> packet) {
   //  }
   //}
   std::lock_guard<std::mutex> lock(mutex_);
+  SendRtpLocked(std::move(packet), 0, info);
+}
+
+void RtpSender::SendRtpPackets(std::vector<std::unique_ptr<RtpPacket>> packets,
+                               uint64_t capture_time_utc_ms,
+                               const FrameSendOptions& options,
+                               uint64_t enqueue_time_us) {
+  packets.erase(std::remove_if(packets.begin(), packets.end(),
+                               [this](const std::unique_ptr<RtpPacket>& p) {
+                                 return (nullptr == p) || !IsValidRtp(*p);
+                               }),
+                packets.end());
+  if (packets.empty()) return;
+  uint64_t utc_ms_now = UTCTimeMillis();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if ((0 != options.deadline_utc_ms) &&
+      (utc_ms_now > options.deadline_utc_ms)) {
+    // Late in the task queue of the signal thread, dropped whole before
+    // it takes any seqs. Given seqs are skipped.
+    ++frames_dropped_expired_;
+    if (!config_->auto_sequencing && has_sent_.load()) {
+      last_seq_ = packets.back()->sequence_number();
+    }
+    return;
+  }
+  if (config_->auto_sequencing &&
+      !AssignSequence(packets, capture_time_utc_ms)) {
+    QOSRTP_LOG(Error,
+               "The media packets protected by a fec packet are not numbered "
+               "consecutively among the packets sent with it, the frame is "
+               "dropped, ssrc(%u)",
+               config_->local_ssrc);
+    return;
+  }
+  PacketSendInfo info;
+  info.enqueue_time_us = enqueue_time_us;
+  if (0 != options.deadline_utc_ms) {
+    info.deadline_us = SteadyTimeMicros() +
+                       (options.deadline_utc_ms - utc_ms_now) *
+                           kNumMicrosecsPerMillisec;
+  }
+  info.droppable = options.droppable;
+  if ((0 != options.deadline_utc_ms) || options.droppable) {
+    info.frame = std::make_shared<SendFrameState>();
+  }
+  info.statistics = send_queue_statistics_;
+  for (auto& packet : packets) {
+    SendRtpLocked(std::move(packet), options.deadline_utc_ms, info);
+  }
+}
+
+bool RtpSender::IsValidRtp(const RtpPacket& packet) const {
+  if (config_->local_ssrc != packet.ssrc()) {
+    QOSRTP_LOG(
+        Error,
+        "The ssrc (%u) of the rtp packet given to RtpSender does not match "
+        "the set ssrc(%u)",
+        packet.ssrc(), config_->local_ssrc);
+    return false;
+  }
+  if (!payload_types_.IsMedia(packet.payload_type())) {
+    QOSRTP_LOG(Error,
+               "The payload_type (%u) of the rtp packet given to RtpSender "
+               "does not match the set payload_type",
+               packet.payload_type());
+    return false;
+  }
+  return true;
+}
+
+bool RtpSender::AssignSequence(std::vector<std::unique_ptr<RtpPacket>>& packets,
+                               uint64_t capture_time_utc_ms) {
+  if (!has_sent_.load()) {
+    // Random initial values, RFC 3550 section 5.1.
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<uint32_t> dis(
+        0, std::numeric_limits<uint32_t>::max());
+    last_seq_ = static_cast<uint16_t>(dis(gen));
+    first_capture_timestamp_ = dis(gen);
+    first_capture_time_utc_ms_ = capture_time_utc_ms;
+  }
+  // Capture times may go back a little between producer threads.
+  int64_t elapsed_ms =
+      static_cast<int64_t>(capture_time_utc_ms - first_capture_time_utc_ms_);
+  uint32_t timestamp =
+      first_capture_timestamp_ +
+      static_cast<uint32_t>(elapsed_ms *
+                            static_cast<int64_t>(config_->rtp_clock_rate_hz) /
+                            1000);
+  uint16_t first_seq =
+      has_sent_.load() ? static_cast<uint16_t>(last_seq_ + 1) : last_seq_;
+  std::vector<uint16_t> given_seqs;
+  std::vector<uint32_t> given_timestamps;
+  given_seqs.reserve(packets.size());
+  given_timestamps.reserve(packets.size());
+  for (const auto& packet : packets) {
+    given_seqs.push_back(packet->sequence_number());
+    given_timestamps.push_back(packet->timestamp());
+  }
+  // Rebased before any seq is taken, a fec packet left pointing at the
+  // given seqs would mislead the receiver into wrong recoveries.
+  if (config_->fec_payload_type >= 0) {
+    for (auto& packet : packets) {
+      if (config_->fec_payload_type != packet->payload_type()) continue;
+      if (!RebaseFecPacket(*packet, given_seqs, given_timestamps, first_seq,
+                           timestamp)) {
+        return false;
+      }
+    }
+  }
+  for (size_t i = 0; i < packets.size(); ++i) {
+    packets[i]->SetSequenceNumber(static_cast<uint16_t>(first_seq + i));
+    packets[i]->SetTimestamp(timestamp);
+  }
+  return true;
+}
+
+bool RtpSender::RebaseFecPacket(RtpPacket& fec_packet,
+                                const std::vector<uint16_t>& given_seqs,
+                                const std::vector<uint32_t>& given_timestamps,
+                                uint16_t first_seq, uint32_t timestamp) {
+  // The payload belongs to the packet being sent, only the api is const.
+  DataBuffer* payload = const_cast<DataBuffer*>(fec_packet.GetPayloadBuffer());
+  if ((nullptr == payload) ||
+      (payload->size() <
+       kUlpfecHeaderLength + 2 + kUlpfecPacketMaskSizeLBitClear)) {
+    return false;
+  }
+  // A slice of a frame copies its bytes here, the frame stays untouched.
+  uint8_t* fec_level_0_header = payload->GetW();
+  if (nullptr == fec_level_0_header) return false;
+  size_t packet_mask_size = (fec_level_0_header[0] & 0x40)
+                                ? kUlpfecPacketMaskSizeLBitSet
+                                : kUlpfecPacketMaskSizeLBitClear;
+  if (payload->size() < kUlpfecHeaderLength + 2 + packet_mask_size) {
+    return false;
+  }
+  const uint8_t* packet_mask = fec_level_0_header + kUlpfecHeaderLength + 2;
+  uint16_t seq_base =
+      ByteReader<uint16_t>::ReadBigEndian(fec_level_0_header + 2);
+  // The seqs keep their offsets from the first given one.
+  uint16_t index_base = seq_base - given_seqs.front();
+  uint32_t ts_recovery =
+      ByteReader<uint32_t>::ReadBigEndian(fec_level_0_header + 4);
+  for (size_t bit = 0; bit < packet_mask_size * 8; ++bit) {
+    if (!(packet_mask[bit / 8] & (0x80 >> (bit % 8)))) continue;
+    size_t index = static_cast<uint16_t>(index_base + bit);
+    if ((index >= given_seqs.size()) ||
+        (given_seqs[index] != static_cast<uint16_t>(seq_base + bit))) {
+      return false;
+    }
+    ts_recovery ^= given_timestamps[index] ^ timestamp;
+  }
+  ByteWriter<uint16_t>::WriteBigEndian(
+      fec_level_0_header + 2, static_cast<uint16_t>(first_seq + index_base));
+  ByteWriter<uint32_t>::WriteBigEndian(fec_level_0_header + 4, ts_recovery);
+  return true;
+}
+
+void RtpSender::SendRtpLocked(std::unique_ptr<RtpPacket> packet,
+                              uint64_t deadline_utc_ms,
+                              const PacketSendInfo& info) {
+  uint8_t m_payload_type_octet = packet->payload_type();
   uint16_t seq = packet->sequence_number();
   if (has_sent_ && (seq != ((last_seq_ == std::numeric_limits<uint16_t>::max())
                                 ? 0
@@ -151,20 +532,10 @@ void RtpSender::SendRtp(std::unique_ptr<RtpPacket> packet) {
         config_->local_ssrc);
     return;
   }
-  if (config_->rtx_enabled) {
-    auto iter_rtx_type =
-        std::find_if(config_->map_rtx_payload_type.begin(),
-                     config_->map_rtx_payload_type.end(),
-                     [&m_payload_type_octet](const auto& element) {
-                       return element.second == m_payload_type_octet;
-                     });
-    if (iter_rtx_type != config_->map_rtx_payload_type.end()) {
-      std::unique_ptr<RtpPacket> cached_packet =
-          RtpPacket::Create(packet.get());
-      cache_->PutPacket(std::move(cached_packet));
-    }
-  }
   uint64_t utc_ms_now = UTCTimeMillis();
+  bool cached = config_->rtx_enabled &&
+                (PayloadTypeTable::kNone !=
+                 payload_types_.RtxPayloadType(m_payload_type_octet));
   if (!has_sent_.load()) {
     utc_ms_first_ = utc_ms_now;
     rtp_timestamp_first_ = packet->timestamp();
@@ -172,8 +543,22 @@ void RtpSender::SendRtp(std::unique_ptr<RtpPacket> packet) {
   }
   sender_packet_count_++;
   sender_octet_count_ +=
-      packet->GetPayloadBuffer() ? packet->GetPayloadBuffer()->size() : 0;
-  tranceiver_->SendRtp(std::move(packet));
+      RtpPacketImpl::PayloadHeaderSize(*packet) +
+      (packet->GetPayloadBuffer() ? packet->GetPayloadBuffer()->size() : 0);
+  // The history shares the sent packet instead of keeping a copy.
+  std::shared_ptr<const RtpPacket> sent_packet = std::move(packet);
+  if (cached) {
+    cache_->PutPacket(sent_packet, utc_ms_now, deadline_utc_ms, info.frame);
+  }
+  if (nullptr != rtx_rate_limiter_) {
+    rtx_rate_limiter_->OnMediaSent(
+        RtpSenderPacketCache::PacketSize(*sent_packet), utc_ms_now);
+  }
+  PacketPriority priority =
+      (config_->fec_payload_type == m_payload_type_octet)
+          ? PacketPriority::kFec
+          : config_->media_priority;
+  tranceiver_->SendRtp(std::move(sent_packet), priority, info);
   last_seq_ = seq;
   has_sent_.store(true);
 }
@@ -182,48 +567,53 @@ void RtpSender::SendRtx(const std::vector<uint16_t>& packet_seqs) {
   if (!(config_->rtx_enabled)) return;
   if (packet_seqs.empty() || (nullptr == cache_)) return;
   std::lock_guard<std::mutex> lock(mutex_);
-  std::vector<std::unique_ptr<RtpPacket>> cached_packets;
-  for (auto iter_seq = packet_seqs.begin(); iter_seq != packet_seqs.end();
-       ++iter_seq) {
-    QOSRTP_LOG(Info, "Receive loss seq: %hu to send rtx", (*iter_seq));
-  }
-  cache_->GetPackets(packet_seqs, cached_packets);
-  for (auto iter_packet = cached_packets.begin();
-       iter_packet != cached_packets.end();) {
-    std::unique_ptr<RtpPacket>& packet = (*iter_packet);
-    std::unique_ptr<RtpPacket> packet_rtx = ConstructRtx(std::move(packet));
-    //QOSRTP_LOG(Info,
-    //           "Send rtx, rtx_ssrc: %u, rtx_payload_type: %hhu, rtx_seq: %hu",
-    //           packet_rtx->ssrc(), packet_rtx->payload_type(),
-    //           packet_rtx->sequence_number());
-    if (nullptr != packet_rtx) tranceiver_->SendRtp(std::move(packet_rtx));
-    iter_packet = cached_packets.erase(iter_packet);
+  uint64_t utc_ms_now = UTCTimeMillis();
+  uint32_t nb_retransmitted = 0;
+  uint32_t nb_rate_limited = 0;
+  for (uint16_t seq : packet_seqs) {
+    std::shared_ptr<const RtpPacket> packet =
+        cache_->GetPacket(seq, utc_ms_now);
+    if (nullptr == packet) continue;
+    // The rtx packet adds the original seq to the packet.
+    uint32_t rtx_size =
+        RtpSenderPacketCache::PacketSize(*packet) + sizeof(uint16_t);
+    if (!rtx_rate_limiter_->TryRetransmit(rtx_size, utc_ms_now)) {
+      ++nb_rate_limited;
+      continue;
+    }
+    // Only the rtx header is built, the payload stays in the history and is
+    // sent from there.
+    std::unique_ptr<DataBuffer> rtx_header = BuildRtxHeader(*packet);
+    if (nullptr == rtx_header) continue;
+    cache_->OnRetransmitted(seq, utc_ms_now);
+    tranceiver_->SendRtx(std::move(rtx_header), std::move(packet));
+    ++nb_retransmitted;
+    rtx_bytes_ += rtx_size;
   }
+  rtx_packets_ += nb_retransmitted;
+  rtx_rate_limited_ += nb_rate_limited;
+  QOSRTP_LOG(Trace,
+             "Nack for %u seqs, ssrc(%u): %u retransmitted, %u rate limited",
+             static_cast<uint32_t>(packet_seqs.size()), config_->local_ssrc,
+             nb_retransmitted, nb_rate_limited);
 }
 
-std::unique_ptr<RtpPacket> RtpSender::ConstructRtx(
-    std::unique_ptr<RtpPacket> packet) {
-  uint8_t m_payload_type_octet = packet->payload_type();
-  auto iter_rtx_type =
-      std::find_if(config_->map_rtx_payload_type.begin(),
-                   config_->map_rtx_payload_type.end(),
-                   [&m_payload_type_octet](const auto& element) {
-                     return element.second == m_payload_type_octet;
-                   });
-  if (iter_rtx_type == config_->map_rtx_payload_type.end()) {
+std::unique_ptr<DataBuffer> RtpSender::BuildRtxHeader(
+    const RtpPacket& packet) {
+  uint8_t m_payload_type_octet =
+      payload_types_.RtxPayloadType(packet.payload_type());
+  if (PayloadTypeTable::kNone == m_payload_type_octet) {
     QOSRTP_LOG(Error,
                "The rtx payload type corresponding to the payload type cannot "
                "be found");
     return nullptr;
   }
-  m_payload_type_octet = iter_rtx_type->first;
-  std::unique_ptr<RtpPacket> packet_rtx = RtpPacket::Create();
-  m_payload_type_octet |= packet->m() ? 0x80 : 0x00;
+  m_payload_type_octet |= packet.m() ? 0x80 : 0x00;
   std::vector<uint32_t> csrcs;
-  uint8_t count_csrcs = packet->count_csrcs();
+  uint8_t count_csrcs = packet.count_csrcs();
   uint8_t csrc = 0;
   for (uint8_t i = 0; i < count_csrcs; i++) {
-    std::unique_ptr<Result> result = packet->csrc(csrc, i);
+    std::unique_ptr<Result> result = packet.csrc(csrc, i);
     if (!result->ok()) {
       QOSRTP_LOG(Error, "Failed to get csrc, because: %s",
                  result->description().c_str());
@@ -231,23 +621,18 @@ std::unique_ptr<RtpPacket> RtpSender::ConstructRtx(
     }
     csrcs.push_back(csrc);
   }
-  std::unique_ptr<RtpPacket::Extension> extension_copy = nullptr;
-  if (packet->x()) {
-    const RtpPacket::Extension* extension_src = packet->GetExtension();
-    extension_copy =
-        std::make_unique<RtpPacket::Extension>(extension_src->length);
-    memcpy(extension_copy->name, extension_src->name, 2);
-    extension_copy->content->ModifyAt(0, extension_src->content->Get(),
-                                      extension_copy->content->size());
-  }
-  std::unique_ptr<DataBuffer> payload_buffer_rtx =
-      DataBuffer::Create(packet->GetPayloadBuffer()->size() + sizeof(uint16_t));
-  payload_buffer_rtx->SetSize(payload_buffer_rtx->capacity());
-  ByteWriter<uint16_t>::WriteBigEndian(payload_buffer_rtx->GetW(),
-                             packet->sequence_number());
-  payload_buffer_rtx->ModifyAt(sizeof(uint16_t),
-                               packet->GetPayloadBuffer()->Get(),
-                               packet->GetPayloadBuffer()->size());
+  const RtpPacket::Extension* extension = packet.x() ? packet.GetExtension()
+                                                     : nullptr;
+  const RtpPacketImpl* packet_impl =
+      dynamic_cast<const RtpPacketImpl*>(&packet);
+  uint8_t payload_header_size =
+      (nullptr != packet_impl) ? packet_impl->payload_header_size() : 0;
+  uint32_t header_size = RtpPacket::kFixedBufferLength +
+                         sizeof(uint32_t) * count_csrcs + sizeof(uint16_t) +
+                         payload_header_size;
+  if (nullptr != extension) {
+    header_size += 4 + extension->content->size();
+  }
   if (!rtx_context.has_sent) {
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -260,18 +645,38 @@ std::unique_ptr<RtpPacket> RtpSender::ConstructRtx(
     rtx_seq = 0;
   else
     rtx_seq++;
-  auto result = packet_rtx->StorePacket(
-      m_payload_type_octet, rtx_seq, packet->timestamp(), config_->rtx_ssrc, csrcs,
-      std::move(extension_copy), std::move(payload_buffer_rtx),
-      packet->pad_size());
-  if (!result->ok()) {
-    QOSRTP_LOG(Error, "Failed to construct rtx packet, because: %s",
-               result->description().c_str());
-    return nullptr;
+  // The padding of the original packet is not carried over, the header
+  // never sets the P bit.
+  std::unique_ptr<DataBuffer> rtx_header = DataBuffer::Create(header_size);
+  rtx_header->SetSize(header_size);
+  uint8_t* write_pos = rtx_header->GetW();
+  write_pos[0] = (RtpPacket::kVersion << 6) |
+                 ((nullptr != extension) ? 0x10 : 0x00) | count_csrcs;
+  write_pos[1] = m_payload_type_octet;
+  ByteWriter<uint16_t>::WriteBigEndian(write_pos + 2, rtx_seq);
+  ByteWriter<uint32_t>::WriteBigEndian(write_pos + 4, packet.timestamp());
+  ByteWriter<uint32_t>::WriteBigEndian(write_pos + 8, config_->rtx_ssrc);
+  write_pos += RtpPacket::kFixedBufferLength;
+  for (uint32_t csrc_rtx : csrcs) {
+    ByteWriter<uint32_t>::WriteBigEndian(write_pos, csrc_rtx);
+    write_pos += sizeof(uint32_t);
+  }
+  if (nullptr != extension) {
+    memcpy(write_pos, extension->name, 2);
+    ByteWriter<uint16_t>::WriteBigEndian(write_pos + 2, extension->length);
+    write_pos += 4;
+    memcpy(write_pos, extension->content->Get(), extension->content->size());
+    write_pos += extension->content->size();
+  }
+  // RFC 4588: the original seq leads the rtx payload.
+  ByteWriter<uint16_t>::WriteBigEndian(write_pos, packet.sequence_number());
+  write_pos += sizeof(uint16_t);
+  if (payload_header_size > 0) {
+    memcpy(write_pos, packet_impl->payload_header(), payload_header_size);
   }
   rtx_context.has_sent = true;
   rtx_context.last_seq = rtx_seq;
-  return packet_rtx;
+  return rtx_header;
 }
 
 bool RtpSender::GetStatisticInfo(NtpTime& ntp_now, uint32_t& rtp_timestamp_now,
@@ -288,4 +693,39 @@ bool RtpSender::GetStatisticInfo(NtpTime& ntp_now, uint32_t& rtp_timestamp_now,
   sender_octet_count = sender_octet_count_;
   return true;
 }
+
+void RtpSender::SetRtt(uint32_t rtt_ms) {
+  if (nullptr == cache_) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_->UpdateRtt(rtt_ms);
+}
+
+std::unique_ptr<RtpSenderStatistics> RtpSender::GetRtpSenderStatistics() {
+  std::unique_ptr<RtpSenderStatistics> statistics =
+      std::make_unique<RtpSenderStatistics>();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (nullptr != cache_) {
+    statistics->history_hits = cache_->nb_hits();
+    statistics->history_misses = cache_->nb_misses();
+    statistics->history_packets = cache_->nb_packets();
+    statistics->history_bytes = cache_->cached_bytes();
+    statistics->history_duration_ms = cache_->duration_ms();
+    statistics->rtx_suppressed = cache_->nb_suppressed();
+    statistics->rtx_expired = cache_->nb_expired();
+    statistics->rtx_dropped = cache_->nb_dropped();
+  }
+  statistics->frames_dropped_expired = frames_dropped_expired_;
+  statistics->packets_dropped_expired =
+      send_queue_statistics_->packets_dropped_expired.load();
+  statistics->packets_dropped_droppable =
+      send_queue_statistics_->packets_dropped_droppable.load();
+  for (uint32_t i = 0; i < SendQueueStatistics::kNbQueueDelayBuckets; ++i) {
+    statistics->queue_delay_histogram[i] =
+        send_queue_statistics_->queue_delay_histogram[i].load();
+  }
+  statistics->rtx_packets = rtx_packets_;
+  statistics->rtx_bytes = rtx_bytes_;
+  statistics->rtx_rate_limited = rtx_rate_limited_;
+  return statistics;
+}
 }  // namespace qosrtp
\ No newline at end of file
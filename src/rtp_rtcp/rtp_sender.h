@@ -1,8 +1,11 @@
 #pragma once
+#include "./payload_type_table.h"
 #include "./rtp_rtcp_tranceiver.h"
 #include "../utils/ntp_time.h"
 #include "../include/result.h"
+#include "../utils/seq_comparison.h"
 
+#include <array>
 #include <mutex>
 #include <vector>
 
@@ -10,13 +13,29 @@ namespace qosrtp {
 struct RtpSenderConfig {
   RtpSenderConfig();
   ~RtpSenderConfig();
+  // Sizes the send history at first, it grows to what the bounds below
+  // need.
   uint16_t max_cache_seq_difference;
+  // Sent packets are kept for max(kRttFactor * rtt, min_history_duration_ms)
+  // within max_history_bytes, 0 for the defaults.
+  uint16_t min_history_duration_ms;
+  uint32_t max_history_bytes;
   uint32_t local_ssrc;
   uint32_t rtp_clock_rate_hz;
   std::vector<uint8_t> rtp_payload_types;
   bool rtx_enabled;
   uint32_t rtx_ssrc;
   std::map<uint8_t, uint8_t> map_rtx_payload_type;
+  // The rtx bitrate is capped at this percentage of the media bitrate, 0
+  // for no cap.
+  uint16_t max_rtx_bitrate_percent;
+  // kAudio or kVideo, the packets of fec_payload_type are paced as kFec.
+  PacketPriority media_priority;
+  // -1 for none.
+  int fec_payload_type;
+  // The seqs and the rtp timestamps of the sent packets are assigned here
+  // instead of being checked.
+  bool auto_sequencing;
 };
 
 class RtpSenderCallback {
@@ -26,18 +45,156 @@ class RtpSenderCallback {
 };
 
 /* This class is not thread-safe */
+// History of the sent packets for rtx. Packets are stored in a power-of-two
+// ring indexed by (seq & mask), so insert, evict and lookup do not search.
+// A packet is kept for max(kRttFactor * rtt, min_duration_ms), long enough
+// for a nack and its retries to come back, and the oldest packets are
+// dropped earlier to stay within max_bytes. The ring doubles when the
+// packets sent in that time do not fit. The packets are shared with the
+// callers of GetPacket, so a lookup does not copy them. The time of the last
+// retransmission of each packet is kept with it, so that repeated nacks
+// within an rtt do not retransmit it again.
 class RtpSenderPacketCache {
  public:
-  RtpSenderPacketCache(uint16_t max_cache_seq_difference);
+  // 0 for min_duration_ms or max_bytes uses the defaults.
+  RtpSenderPacketCache(uint16_t initial_nb_packets, uint16_t min_duration_ms,
+                       uint32_t max_bytes);
   ~RtpSenderPacketCache();
-  /* It is required that the seq of the incoming packet is continuous */
-  void PutPacket(std::unique_ptr<RtpPacket> packet);
-  void GetPackets(const std::vector<uint16_t>& packet_seqs,
-                  std::vector<std::unique_ptr<RtpPacket>>& out_packets);
+  /* It is required that the seq of the incoming packet "increases" */
+  // The packet is not retransmitted after deadline_utc_ms, 0 for none, nor
+  // once its frame was dropped on the way to the network.
+  void PutPacket(std::shared_ptr<const RtpPacket> packet, uint64_t utc_ms_now,
+                 uint64_t deadline_utc_ms,
+                 std::shared_ptr<const SendFrameState> frame);
+  // nullptr if seq is no longer cached, counted as a miss, if it was
+  // retransmitted less than an rtt ago, counted as suppressed, if it is
+  // past its deadline, counted as expired, or if its frame was dropped,
+  // counted as dropped.
+  std::shared_ptr<const RtpPacket> GetPacket(uint16_t seq,
+                                             uint64_t utc_ms_now);
+  void OnRetransmitted(uint16_t seq, uint64_t utc_ms_now);
+  // A lower rtt frees the packets that are no longer needed at the next
+  // PutPacket.
+  void UpdateRtt(uint32_t rtt_ms) { rtt_ms_ = rtt_ms; }
+  uint32_t duration_ms() const;
+  uint32_t nb_packets() const { return nb_packets_; }
+  uint32_t cached_bytes() const { return cached_bytes_; }
+  uint32_t max_bytes() const { return max_bytes_; }
+  uint32_t nb_hits() const { return nb_hits_; }
+  uint32_t nb_misses() const { return nb_misses_; }
+  uint32_t nb_suppressed() const { return nb_suppressed_; }
+  uint32_t nb_expired() const { return nb_expired_; }
+  uint32_t nb_dropped() const { return nb_dropped_; }
+  static uint32_t PacketSize(const RtpPacket& packet);
 
  private:
-  std::vector<std::unique_ptr<RtpPacket>> cached_rtp_packets_;
-  uint16_t max_cache_seq_difference_;
+  static constexpr uint32_t kRttFactor = 3;
+  // Used until the first rtt is measured.
+  static constexpr uint32_t kDefaultRttMs = 300;
+  // The nack interval of the receiver before it knows the rtt, shorter than
+  // kDefaultRttMs so that its nacks are not suppressed.
+  static constexpr uint32_t kDefaultRetransmitIntervalMs = 50;
+  static constexpr uint16_t kDefaultMinDurationMs = 100;
+  static constexpr uint32_t kDefaultMaxBytes = 8 * 1024 * 1024;
+  static constexpr uint32_t kMinCapacity = 64;
+  // Half the seq space, larger rings would make seq & mask ambiguous.
+  static constexpr uint32_t kMaxCapacity = 1 << 15;
+  static uint32_t CalculateCapacity(uint16_t nb_packets);
+  struct CachedPacket {
+    std::shared_ptr<const RtpPacket> packet;
+    uint64_t send_time_utc_ms = 0;
+    // 0 if not retransmitted yet.
+    uint64_t retransmit_time_utc_ms = 0;
+    uint64_t deadline_utc_ms = 0;
+    std::shared_ptr<const SendFrameState> frame;
+    uint32_t size = 0;
+  };
+  // nullptr if seq is not cached.
+  CachedPacket* Find(uint16_t seq);
+  // Doubles the ring, false if it is already at kMaxCapacity.
+  bool Grow();
+  void RemoveOldest();
+  // Drops the packets older than duration_ms() or over max_bytes_, the
+  // newest packet is always kept.
+  void Evict(uint64_t utc_ms_now);
+  std::vector<CachedPacket> slots_;
+  uint32_t mask_;
+  const uint16_t min_duration_ms_;
+  const uint32_t max_bytes_;
+  uint32_t rtt_ms_;
+  uint32_t nb_packets_;
+  uint32_t cached_bytes_;
+  uint32_t nb_hits_;
+  uint32_t nb_misses_;
+  uint32_t nb_suppressed_;
+  uint32_t nb_expired_;
+  uint32_t nb_dropped_;
+  SeqUnwrapper seq_unwrapper_;
+  // The cached packets are within [oldest_seq_, newest_seq_], both hold a
+  // packet.
+  int64_t oldest_seq_;
+  int64_t newest_seq_;
+};
+
+/* This class is not thread-safe */
+// Caps the rtx bitrate at max_percent of the media bitrate, measured over
+// the last kWindowMs. A token bucket gains budget at the capped rate, up to
+// kMaxBurstMs of it, and each retransmission takes its size from it.
+class RtxRateLimiter {
+ public:
+  // 0 for max_percent lets every retransmission through.
+  explicit RtxRateLimiter(uint16_t max_percent);
+  ~RtxRateLimiter();
+  void OnMediaSent(uint32_t size, uint64_t utc_ms_now);
+  // Takes size from the budget, false if it does not fit.
+  bool TryRetransmit(uint32_t size, uint64_t utc_ms_now);
+  uint32_t media_bitrate_bps() const;
+
+ private:
+  static constexpr uint32_t kSlotMs = 100;
+  static constexpr uint32_t kNbSlots = 10;
+  static constexpr uint32_t kWindowMs = kSlotMs * kNbSlots;
+  static constexpr uint32_t kMaxBurstMs = 500;
+  void Advance(uint64_t utc_ms_now);
+  const uint16_t max_percent_;
+  // Media bytes sent in each kSlotMs of the window, slot_index_ is the
+  // current one.
+  std::array<uint32_t, kNbSlots> slot_bytes_;
+  uint32_t slot_index_;
+  uint64_t slot_start_utc_ms_;
+  uint64_t first_utc_ms_;
+  bool has_media_;
+  uint32_t window_bytes_;
+  // In bits * 10^-3, the capped rate in bps times the elapsed ms.
+  int64_t budget_millibits_;
+  uint64_t budget_update_utc_ms_;
+};
+
+struct RtpSenderStatistics {
+  // Nacked seqs found in the send history, and the ones already dropped.
+  uint32_t history_hits = 0;
+  uint32_t history_misses = 0;
+  uint32_t history_packets = 0;
+  uint32_t history_bytes = 0;
+  uint32_t history_duration_ms = 0;
+  uint32_t rtx_packets = 0;
+  uint32_t rtx_bytes = 0;
+  // Nacked seqs not retransmitted, because they were less than an rtt ago
+  // or because of the rtx bitrate cap.
+  uint32_t rtx_suppressed = 0;
+  uint32_t rtx_rate_limited = 0;
+  // Nacked seqs of frames past their deadline, and of frames dropped on
+  // their way to the network.
+  uint32_t rtx_expired = 0;
+  uint32_t rtx_dropped = 0;
+  // Frames past their deadline before they were sequenced, and packets
+  // dropped later on, past their deadline or droppable.
+  uint32_t frames_dropped_expired = 0;
+  uint32_t packets_dropped_expired = 0;
+  uint32_t packets_dropped_droppable = 0;
+  // From the media session to the network, see SendQueueStatistics.
+  std::array<uint32_t, SendQueueStatistics::kNbQueueDelayBuckets>
+      queue_delay_histogram = {};
 };
 
 class RtpSender {
@@ -49,11 +206,23 @@ class RtpSender {
                                      RtpRtcpTranceiver* tranceiver,
                                      std::unique_ptr<RtpSenderConfig> config);
   void SendRtx(const std::vector<uint16_t>& packet_seqs);
+  // With auto_sequencing the packet is a frame of its own, captured now.
   void SendRtp(std::unique_ptr<RtpPacket> packet);
+  // With auto_sequencing the packets get consecutive seqs and the rtp
+  // timestamp of capture_time_utc_ms under one lock, see AssignSequence.
+  // The frame is dropped past options.deadline_utc_ms, here or on its way
+  // to the network. enqueue_time_us is the SteadyTimeMicros the frame was
+  // handed over at.
+  void SendRtpPackets(std::vector<std::unique_ptr<RtpPacket>> packets,
+                      uint64_t capture_time_utc_ms,
+                      const FrameSendOptions& options,
+                      uint64_t enqueue_time_us);
   bool HasSentRtp() { return has_sent_.load(); }
   bool GetStatisticInfo(NtpTime& ntp_now, uint32_t& rtp_timestamp_now,
                         uint32_t& sender_packet_count,
                         uint32_t& sender_octet_count);
+  void SetRtt(uint32_t rtt_ms);
+  std::unique_ptr<RtpSenderStatistics> GetRtpSenderStatistics();
 
  private:
   struct RtxContext {
@@ -62,12 +231,35 @@ class RtpSender {
     uint16_t last_seq;
     bool has_sent;
   };
-  std::unique_ptr<RtpPacket> ConstructRtx(std::unique_ptr<RtpPacket> packet);
+  // The header of the rtx packet for packet and the original seq (RFC 4588),
+  // the payload of packet follows it on the wire.
+  std::unique_ptr<DataBuffer> BuildRtxHeader(const RtpPacket& packet);
+  bool IsValidRtp(const RtpPacket& packet) const;
+  // Numbers the packets on from the last sent one, the fec packets among
+  // them are rebased onto the new seqs and timestamps of the media packets
+  // they protect. False, with nothing numbered, if one of them protects
+  // packets not given with it.
+  bool AssignSequence(std::vector<std::unique_ptr<RtpPacket>>& packets,
+                      uint64_t capture_time_utc_ms);
+  bool RebaseFecPacket(RtpPacket& fec_packet,
+                       const std::vector<uint16_t>& given_seqs,
+                       const std::vector<uint32_t>& given_timestamps,
+                       uint16_t first_seq, uint32_t timestamp);
+  // Needs mutex_.
+  void SendRtpLocked(std::unique_ptr<RtpPacket> packet,
+                     uint64_t deadline_utc_ms, const PacketSendInfo& info);
   RtxContext rtx_context;
   RtpSenderCallback* sender_callback_;
   RtpRtcpTranceiver* tranceiver_;
   std::unique_ptr<RtpSenderConfig> config_;
+  PayloadTypeTable payload_types_;
   std::unique_ptr<RtpSenderPacketCache> cache_;
+  std::unique_ptr<RtxRateLimiter> rtx_rate_limiter_;
+  uint32_t rtx_packets_;
+  uint32_t rtx_bytes_;
+  uint32_t rtx_rate_limited_;
+  uint32_t frames_dropped_expired_;
+  std::shared_ptr<SendQueueStatistics> send_queue_statistics_;
   std::atomic<bool> has_sent_;
   uint16_t last_seq_;
   std::mutex mutex_;
@@ -76,5 +268,8 @@ class RtpSender {
   uint32_t rtp_clock_rate_;
   uint32_t sender_packet_count_;
   uint32_t sender_octet_count_;
+  // With auto_sequencing, the rtp timestamp of the first capture time.
+  uint64_t first_capture_time_utc_ms_;
+  uint32_t first_capture_timestamp_;
 };
 }  // namespace qosrtp
\ No newline at end of file
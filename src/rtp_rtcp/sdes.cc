@@ -1,7 +1,5 @@
 #include "sdes.h"
 
-#include <sstream>
-
 #include "../utils/byte_io.h"
 
 using namespace qosrtp;
@@ -19,16 +17,14 @@ uint32_t Sdes::ChunkSize(const Sdes::Chunk& chunk) {
   return chunk_payload_size + padding_size;
 }
 
-std::unique_ptr<Result> Sdes::StorePacket(const CommonHeader& packet) {
+Status Sdes::StorePacket(const CommonHeader& packet) {
   if (kPacketType != packet.type()) {
-    return Result::Create(-1, "The type of rtcp is not sdes.");
+    return Status::Error("The type of rtcp is not sdes.");
   }
   if (packet.payload_size_bytes() % 4 != 0) {
-    std::stringstream result_description;
-    result_description << "Invalid payload size " << packet.payload_size_bytes()
-                       << " bytes for a valid Sdes packet. Size should be"
-                          " multiple of 4 bytes";
-    return Result::Create(-1, result_description.str());
+    return Status::Error(
+        "Invalid payload size for a valid Sdes packet. Size should be "
+        "multiple of 4 bytes.");
   }
   uint8_t number_of_chunks = packet.count();
   std::vector<Chunk> chunks;  // Read chunk into temporary array, so that in
@@ -42,9 +38,7 @@ std::unique_ptr<Result> Sdes::StorePacket(const CommonHeader& packet) {
   for (uint32_t i = 0; i < number_of_chunks;) {
     // Each chunk consumes at least 8 bytes.
     if (payload_end - looking_at < 8) {
-      std::stringstream result_description;
-      result_description << "Not enough space left for chunk #" << (i + 1);
-      return Result::Create(-1, result_description.str());
+      return Status::Error("Not enough space left for chunk.");
     }
     chunks[i].ssrc = ByteReader<uint32_t>::ReadBigEndian(looking_at);
     looking_at += sizeof(uint32_t);
@@ -53,26 +47,20 @@ std::unique_ptr<Result> Sdes::StorePacket(const CommonHeader& packet) {
     uint8_t item_type;
     while ((item_type = *(looking_at++)) != kTerminatorTag) {
       if (looking_at >= payload_end) {
-        std::stringstream result_description;
-        result_description << "Unexpected end of packet while reading chunk #"
-                           << (i + 1) << ". Expected to find size of the text.";
-        return Result::Create(-1, result_description.str());
+        return Status::Error(
+            "Unexpected end of packet while reading chunk. Expected to find "
+            "size of the text.");
       }
       uint8_t item_length = *(looking_at++);
       const uint32_t kTerminatorSize = 1;
       if (looking_at + item_length + kTerminatorSize > payload_end) {
-        std::stringstream result_description;
-        result_description << "Unexpected end of packet while reading chunk #"
-                           << (i + 1) << ". Expected to find text of size "
-                           << item_length;
-        return Result::Create(-1, result_description.str());
+        return Status::Error(
+            "Unexpected end of packet while reading chunk. Expected to find "
+            "text of item length.");
       }
       if (item_type == kCnameTag) {
         if (cname_found) {
-          std::stringstream result_description;
-          result_description << "Found extra CNAME for same ssrc in chunk #"
-                             << (i + 1);
-          return Result::Create(-1, result_description.str());
+          return Status::Error("Found extra CNAME for same ssrc in chunk.");
         }
         cname_found = true;
         chunks[i].cname.assign(reinterpret_cast<const char*>(looking_at),
@@ -98,34 +86,34 @@ std::unique_ptr<Result> Sdes::StorePacket(const CommonHeader& packet) {
   }
   chunks_ = std::move(chunks);
   chunks_buffer_length_ = chunks_buffer_length;
-  return Result::Create();
+  return Status::Ok();
 }
 
-std::unique_ptr<Result> Sdes::AddCName(uint32_t ssrc, std::string cname) {
+Status Sdes::AddCName(uint32_t ssrc, std::string cname) {
   if (cname.length() > (uint8_t)0xff) {
-    return Result::Create(-1, "The length of cname must be shorter than 255.");
+    return Status::Error("The length of cname must be shorter than 255.");
   }
   if (chunks_.size() >= kMaxNumberOfChunks) {
-    return Result::Create(-1, "Max SDES chunks reached.");
+    return Status::Error("Max SDES chunks reached.");
   }
   Chunk chunk;
   chunk.ssrc = ssrc;
   chunk.cname = std::move(cname);
   chunks_.push_back(chunk);
   chunks_buffer_length_ += ChunkSize(chunk);
-  return Result::Create();
+  return Status::Ok();
 }
 
 uint32_t Sdes::BlockLength() const {
   return chunks_buffer_length_ + kHeaderLength;
 }
 
-std::unique_ptr<Result> Sdes::LoadPacket(uint8_t* packet, uint32_t* pos,
-                                         uint32_t max_length) const {
+Status Sdes::LoadPacket(uint8_t* packet, uint32_t* pos,
+                        uint32_t max_length) const {
   if (*pos + BlockLength() > max_length) {
-    return Result::Create(-1,
-                          "The remaining buffer space is less than the length "
-                          "of the loaded packet");
+    return Status::Error(
+        "The remaining buffer space is less than the length "
+        "of the loaded packet");
   }
   const uint32_t index_end = *pos + BlockLength();
   CreateHeader(chunks_.size(), kPacketType,
@@ -145,5 +133,5 @@ std::unique_ptr<Result> Sdes::LoadPacket(uint8_t* packet, uint32_t* pos,
     memset(packet + *pos, kPadding, padding_size);
     *pos += padding_size;
   }
-  return Result::Create();
+  return Status::Ok();
 }
@@ -47,15 +47,15 @@ class Sdes : public RtcpPacket {
   virtual ~Sdes() override;
 
   // Parse assumes header is already parsed and validated.
-  std::unique_ptr<Result> StorePacket(const CommonHeader& packet);
+  Status StorePacket(const CommonHeader& packet);
 
-  std::unique_ptr<Result> AddCName(uint32_t ssrc, std::string cname);
+  Status AddCName(uint32_t ssrc, std::string cname);
 
   const std::vector<Chunk>& chunks() const { return chunks_; }
 
   virtual uint32_t BlockLength() const override;
 
-  virtual std::unique_ptr<Result> LoadPacket(
+  virtual Status LoadPacket(
       uint8_t* packet, uint32_t* pos, uint32_t max_length) const override;
 
  private:
@@ -14,22 +14,21 @@ SenderReport::SenderReport()
 
 SenderReport::~SenderReport() = default;
 
-std::unique_ptr<Result> SenderReport::AddReportBlock(
-    std::unique_ptr<ReportBlock> block) {
+Status SenderReport::AddReportBlock(std::unique_ptr<ReportBlock> block) {
   if (report_blocks_.size() >= kMaxNumberOfReportBlocks) {
-    return Result::Create(-1, "Max report blocks reached.");
+    return Status::Error("Max report blocks reached.");
   }
   report_blocks_.push_back(std::move(block));
-  return Result::Create();
+  return Status::Ok();
 }
 
-std::unique_ptr<Result> SenderReport::SetReportBlocks(
+Status SenderReport::SetReportBlocks(
     std::vector<std::unique_ptr<ReportBlock>> blocks) {
   if (blocks.size() > kMaxNumberOfReportBlocks) {
-    return Result::Create(-1, "Max report blocks reached.");
+    return Status::Error("Max report blocks reached.");
   }
   report_blocks_ = std::move(blocks);
-  return Result::Create();
+  return Status::Ok();
 }
 
 uint32_t SenderReport::BlockLength() const {
@@ -37,13 +36,13 @@ uint32_t SenderReport::BlockLength() const {
          report_blocks_.size() * ReportBlock::kLength;
 }
 
-std::unique_ptr<Result> SenderReport::LoadPacket(uint8_t* packet,
-                                                  uint32_t* pos,
-                                                  uint32_t max_length) const {
+Status SenderReport::LoadPacket(uint8_t* packet,
+                                uint32_t* pos,
+                                uint32_t max_length) const {
   if (max_length < (*pos) + BlockLength()) {
-    return Result::Create(-1,
-                          "The remaining buffer space is less than the length "
-                          "of the loaded packet");
+    return Status::Error(
+        "The remaining buffer space is less than the length "
+        "of the loaded packet");
   }
   RtcpPacket::CreateHeader(report_blocks_.size(), SenderReport::kPacketType,
                            (BlockLength() - kHeaderLength) / sizeof(uint32_t),
@@ -63,21 +62,21 @@ std::unique_ptr<Result> SenderReport::LoadPacket(uint8_t* packet,
     block->LoadPacket(packet + *pos);
     *pos += ReportBlock::kLength;
   }
-  return Result::Create();
+  return Status::Ok();
 }
 
-std::unique_ptr<Result> SenderReport::StorePacket(const CommonHeader& packet) {
+Status SenderReport::StorePacket(const CommonHeader& packet) {
   if (packet.type() != kPacketType) {
-    return Result::Create(-1, "The type of rtcp is not sender report.");
+    return Status::Error("The type of rtcp is not sender report.");
   }
   if (packet.payload() == nullptr) {
-    return Result::Create(
-        -1, "It is meaningless to parse a package with a payload of nullptr");
+    return Status::Error(
+        "It is meaningless to parse a package with a payload of nullptr");
   }
   const uint8_t report_block_count = packet.count();
   if (packet.payload_size_bytes() <
       kSenderBaseLength + report_block_count * ReportBlock::kLength) {
-    return Result::Create(-1, "Packet is too small to contain all the data.");
+    return Status::Error("Packet is too small to contain all the data.");
   }
   if (packet.payload_size_bytes() >
       kSenderBaseLength + report_block_count * ReportBlock::kLength) {
@@ -85,8 +84,8 @@ std::unique_ptr<Result> SenderReport::StorePacket(const CommonHeader& packet) {
                                  kSenderBaseLength +
                                  report_block_count * ReportBlock::kLength;
     if ((extensions_length % 4) != 0) {
-      return Result::Create(
-          -1, "The length of the rtcp extension must be divisible by 4.");
+      return Status::Error(
+          "The length of the rtcp extension must be divisible by 4.");
     }
     // It does not intend to process the extension, nor does it intend to inform
     // the caller of the extension. The processing of the report is isolated
@@ -104,14 +103,12 @@ std::unique_ptr<Result> SenderReport::StorePacket(const CommonHeader& packet) {
   report_blocks_.resize(report_block_count);
   const uint8_t* next_block = payload + kSenderBaseLength;
   for (auto& block : report_blocks_) {
-    auto block_parsed = block->StorePacket(next_block);
-    if (!block_parsed->ok()) {
-      std::stringstream result_description;
-      result_description << "Failed to parse report block, because:"
-                         << "\"" << block_parsed->description() << "\"."; 
-      return Result::Create(-1, result_description.str());
+    block = std::make_unique<ReportBlock>();
+    Status block_parsed = block->StorePacket(next_block);
+    if (!block_parsed.ok()) {
+      return block_parsed;
     }
     next_block += ReportBlock::kLength;
   }
-  return Result::Create();
+  return Status::Ok();
 }
\ No newline at end of file
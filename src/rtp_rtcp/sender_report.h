@@ -2,7 +2,7 @@
 #include <memory>
 #include <vector>
 
-#include "../include/result.h"
+#include "../utils/status.h"
 #include "../utils/ntp_time.h"
 #include "common_header.h"
 #include "report_block.h"
@@ -39,7 +39,7 @@ class SenderReport : public RtcpPacket {
 
   virtual uint32_t BlockLength() const override;
 
-  virtual std::unique_ptr<Result> LoadPacket(
+  virtual Status LoadPacket(
       uint8_t* packet, uint32_t* pos, uint32_t max_length) const override;
   NtpTime ntp() const { return ntp_; }
   uint32_t rtp_timestamp() const { return rtp_timestamp_; }
@@ -54,7 +54,7 @@ class SenderReport : public RtcpPacket {
   }
 
   // StorePacket assumes header is already parsed and validated.
-  std::unique_ptr<Result> StorePacket(const CommonHeader& packet);
+  Status StorePacket(const CommonHeader& packet);
   void SetNtp(NtpTime ntp) { ntp_ = ntp; }
   void SetRtpTimestamp(uint32_t rtp_timestamp) {
     rtp_timestamp_ = rtp_timestamp;
@@ -65,9 +65,8 @@ class SenderReport : public RtcpPacket {
   void SetOctetCount(uint32_t octet_count) {
     sender_octet_count_ = octet_count;
   }
-  std::unique_ptr<Result> AddReportBlock(std::unique_ptr<ReportBlock> block);
-  std::unique_ptr<Result> SetReportBlocks(
-      std::vector<std::unique_ptr<ReportBlock>> blocks);
+  Status AddReportBlock(std::unique_ptr<ReportBlock> block);
+  Status SetReportBlocks(std::vector<std::unique_ptr<ReportBlock>> blocks);
   void ClearReportBlocks() { report_blocks_.clear(); }
 
  private:
@@ -0,0 +1,85 @@
+#include "target_delay_estimator.h"
+
+#include <algorithm>
+
+namespace qosrtp {
+TargetDelayEstimator::TargetDelayEstimator(uint16_t min_delay_ms,
+                                           uint16_t max_delay_ms)
+    : min_delay_ms_(min_delay_ms),
+      max_delay_ms_(std::max(min_delay_ms, max_delay_ms)),
+      rtt_ms_(0),
+      jitter_ms_(0),
+      packet_interval_ms_(0),
+      reorder_delay_ms_(0),
+      last_arrival_utc_ms_(0),
+      last_loss_utc_ms_(0),
+      last_loss_burst_(0),
+      last_update_utc_ms_(0),
+      current_delay_ms_(max_delay_ms_),
+      target_delay_ms_(max_delay_ms_) {}
+
+TargetDelayEstimator::~TargetDelayEstimator() = default;
+
+void TargetDelayEstimator::OnPacketArrival(uint64_t utc_ms_now,
+                                           int64_t reorder_distance) {
+  if (min_delay_ms_ == max_delay_ms_) return;
+  if (0 == reorder_distance) {
+    if (0 != last_arrival_utc_ms_) {
+      double interval_ms =
+          static_cast<double>(utc_ms_now - last_arrival_utc_ms_);
+      packet_interval_ms_ = (0 == packet_interval_ms_)
+                                ? interval_ms
+                                : (packet_interval_ms_ * 7 + interval_ms) / 8;
+    }
+    last_arrival_utc_ms_ = utc_ms_now;
+  } else {
+    reorder_delay_ms_ = std::max(
+        reorder_delay_ms_, reorder_distance * packet_interval_ms_);
+  }
+  Update(utc_ms_now);
+}
+
+void TargetDelayEstimator::OnLoss(uint64_t utc_ms_now, int64_t nb_lost) {
+  if (min_delay_ms_ == max_delay_ms_) return;
+  last_loss_utc_ms_ = utc_ms_now;
+  last_loss_burst_ = nb_lost;
+  Update(utc_ms_now);
+}
+
+void TargetDelayEstimator::UpdateRtt(uint32_t rtt_ms, uint32_t jitter_ms) {
+  rtt_ms_ = rtt_ms;
+  jitter_ms_ = jitter_ms;
+}
+
+void TargetDelayEstimator::Update(uint64_t utc_ms_now) {
+  double elapsed_s =
+      (0 == last_update_utc_ms_)
+          ? 0
+          : static_cast<double>(utc_ms_now - last_update_utc_ms_) / 1000.0;
+  last_update_utc_ms_ = utc_ms_now;
+  reorder_delay_ms_ =
+      std::max(0.0, reorder_delay_ms_ - kReorderDecayMsPerSecond * elapsed_s);
+  double desired_delay_ms = std::max(
+      static_cast<double>(kJitterFactor * jitter_ms_), reorder_delay_ms_);
+  if ((0 != last_loss_utc_ms_) &&
+      (utc_ms_now - last_loss_utc_ms_ < kLossMemoryMs)) {
+    uint32_t rtt_ms = (0 == rtt_ms_) ? kDefaultRttMs : rtt_ms_;
+    int64_t nb_rounds = std::min<int64_t>(last_loss_burst_, 2);
+    desired_delay_ms =
+        std::max(desired_delay_ms,
+                 static_cast<double>(nb_rounds * (rtt_ms + jitter_ms_ +
+                                                  kRetransmissionMarginMs)));
+  }
+  if (desired_delay_ms >= current_delay_ms_) {
+    current_delay_ms_ = desired_delay_ms;
+  } else {
+    current_delay_ms_ =
+        std::max(desired_delay_ms,
+                 current_delay_ms_ - kMaxDecreaseMsPerSecond * elapsed_s);
+  }
+  current_delay_ms_ = std::clamp(current_delay_ms_,
+                                 static_cast<double>(min_delay_ms_),
+                                 static_cast<double>(max_delay_ms_));
+  target_delay_ms_ = static_cast<uint16_t>(current_delay_ms_ + 0.5);
+}
+}  // namespace qosrtp
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+namespace qosrtp {
+// Target delay of the receive jitter buffer, the time a packet is held for
+// the packets before it. It covers the interarrival jitter and the learned
+// reorder depth, and while packets are being lost also one retransmission
+// round trip per lost packet of the last burst (at most two), so that
+// NACK/RTX can repair the loss in time. The target grows at once and
+// shrinks by at most kMaxDecreaseMsPerSecond, within [min, max].
+class TargetDelayEstimator {
+ public:
+  TargetDelayEstimator(uint16_t min_delay_ms, uint16_t max_delay_ms);
+  ~TargetDelayEstimator();
+  // reorder_distance is how many seqs the packet is behind the highest
+  // received seq, 0 for a packet received in order.
+  void OnPacketArrival(uint64_t utc_ms_now, int64_t reorder_distance);
+  void OnLoss(uint64_t utc_ms_now, int64_t nb_lost);
+  // 0 for rtt_ms means the rtt is unknown.
+  void UpdateRtt(uint32_t rtt_ms, uint32_t jitter_ms);
+  uint16_t target_delay_ms() const { return target_delay_ms_; }
+
+ private:
+  static constexpr uint32_t kDefaultRttMs = 100;
+  static constexpr uint32_t kJitterFactor = 3;
+  static constexpr uint32_t kRetransmissionMarginMs = 10;
+  // A loss older than this no longer asks for retransmission time.
+  static constexpr uint64_t kLossMemoryMs = 5000;
+  static constexpr double kMaxDecreaseMsPerSecond = 20.0;
+  // Learned reorder depth, forgotten at this rate.
+  static constexpr double kReorderDecayMsPerSecond = 10.0;
+  void Update(uint64_t utc_ms_now);
+  uint16_t min_delay_ms_;
+  uint16_t max_delay_ms_;
+  uint32_t rtt_ms_;
+  uint32_t jitter_ms_;
+  double packet_interval_ms_;
+  double reorder_delay_ms_;
+  uint64_t last_arrival_utc_ms_;
+  uint64_t last_loss_utc_ms_;
+  int64_t last_loss_burst_;
+  uint64_t last_update_utc_ms_;
+  double current_delay_ms_;
+  uint16_t target_delay_ms_;
+};
+}  // namespace qosrtp
\ No newline at end of file
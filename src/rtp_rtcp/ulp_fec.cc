@@ -6,6 +6,7 @@
 #include "./fec_private_tables_random.h"
 #include "../include/log.h"
 #include "../utils/time_utils.h"
+#include "./rtp_packet_impl.h"
 
 namespace qosrtp {
 UlpFecEncoder::UlpFecEncoder() : config_(nullptr) {
@@ -41,17 +42,29 @@ std::unique_ptr<Result> UlpFecEncoder::Encode(
     ImportantPacketsProtectionMethod method_protect_important_packets,
     uint8_t protection_factor, FecMaskType fec_mask_type,
     std::vector<std::unique_ptr<RtpPacket>>& fec_packets) {
+  return Protect(protected_packets, num_important_packets,
+                 method_protect_important_packets, protection_factor,
+                 fec_mask_type, fec_packets)
+      .ToResult();
+}
+
+Status UlpFecEncoder::Protect(
+    const std::vector<const RtpPacket*>& protected_packets,
+    uint32_t num_important_packets,
+    ImportantPacketsProtectionMethod method_protect_important_packets,
+    uint8_t protection_factor, FecMaskType fec_mask_type,
+    std::vector<std::unique_ptr<RtpPacket>>& fec_packets) {
   size_t nb_protected_packets = protected_packets.size();
   if (0 == nb_protected_packets) {
-    return Result::Create(-1, "protected_packets is empty");
+    return Status::Error("protected_packets is empty");
   }
   if (kUlpfecMaxMediaPackets < nb_protected_packets) {
-    return Result::Create(-1, "The size of protected_packets is too large");
+    return Status::Error("The size of protected_packets is too large");
   }
   if (num_important_packets > nb_protected_packets) {
-    return Result::Create(-1,
-                          "num_important_packets must be less than or equal to "
-                          "the size of protected_packets");
+    return Status::Error(
+        "num_important_packets must be less than or equal to the size of "
+        "protected_packets");
   }
   std::vector<std::unique_ptr<RtpPacketData>> input_packets;
   uint16_t last_seq = 0;
@@ -60,12 +73,12 @@ std::unique_ptr<Result> UlpFecEncoder::Encode(
        ++iter_protected_packet) {
     const RtpPacket* protected_packet = (*iter_protected_packet);
     if (config_->ssrc() != protected_packet->ssrc()) {
-      return Result::Create(-1, "ssrc is different from the set value");
+      return Status::Error("ssrc is different from the set value");
     }
     if (iter_protected_packet != protected_packets.begin()) {
       if (!IsNextSeq(last_seq, protected_packet->sequence_number())) {
-        return Result::Create(
-            -1, "The sequence number must be continuously increasing");
+        return Status::Error(
+            "The sequence number must be continuously increasing");
       }
     }
     last_seq = protected_packet->sequence_number();
@@ -81,7 +94,7 @@ std::unique_ptr<Result> UlpFecEncoder::Encode(
                       fec_mask_type, packet_mask_size, fec_packet_mask_);
   GenerateFecPackets(input_packets, num_fec_packets, packet_mask_size,
                      fec_packets);
-  return Result::Create();
+  return Status::Ok();
 }
 
 void UlpFecEncoder::GenerateFecPackets(
@@ -175,10 +188,11 @@ std::unique_ptr<RtpPacket> UlpFecEncoder::BuildFecPacket(
   fec_level_0_header[3] ^= seq_base_network_order[1];
   fec_level_0_header[0] &= 0x3f;
   if (l) fec_level_0_header[0] |= 0x40;
-  std::unique_ptr<RtpPacket> fec_packet = RtpPacket::Create();
+  std::unique_ptr<RtpPacketImpl> fec_packet =
+      std::make_unique<RtpPacketImpl>();
   std::vector<uint32_t> csrcs;
-  fec_packet->StorePacket(config_->payload_type(), 0, 0, config_->ssrc(), csrcs,
-                          nullptr, std::move(fec_payload), 0);
+  fec_packet->Store(config_->payload_type(), 0, 0, config_->ssrc(), csrcs,
+                    nullptr, std::move(fec_payload), 0);
   return fec_packet;
 }
 
@@ -515,19 +529,16 @@ void UlpFecDecoder::Decode(
   uint64_t trace_2 = UTCTimeMillis();
   RcoverPackets();
   uint64_t trace_3 = UTCTimeMillis();
-  uint16_t latest_cached_seq =
-      cached_packets_.back()->rtp_struct->sequence_number();
+  uint16_t latest_cached_seq = cached_packets_.back()->seq;
   for (auto iter_cached_packet = cached_packets_.begin();
        iter_cached_packet != cached_packets_.end();) {
-    if (IsSeqBeforeInRange(
-            (*iter_cached_packet)->rtp_struct->sequence_number(),
-            latest_cached_seq, config_->max_cache_seq_difference())) {
+    if (IsSeqBeforeInRange((*iter_cached_packet)->seq, latest_cached_seq,
+                           config_->max_cache_seq_difference())) {
       break;
     }
     bool output = false;
     if (!has_output_ ||
-        IsSeqAfter(seq_last_output_,
-                   (*iter_cached_packet)->rtp_struct->sequence_number())) {
+        IsSeqAfter(seq_last_output_, (*iter_cached_packet)->seq)) {
       output = true;
     }
     if (output) {
@@ -539,13 +550,12 @@ void UlpFecDecoder::Decode(
        iter_cached_packet != cached_packets_.end(); ++iter_cached_packet) {
     if (recovered_packets.empty()) {
       if (has_output_ &&
-          !IsSeqAfter(seq_last_output_,
-                      (*iter_cached_packet)->rtp_struct->sequence_number())) {
+          !IsSeqAfter(seq_last_output_, (*iter_cached_packet)->seq)) {
         break;
       }
     } else {
       if (!IsNextSeq(recovered_packets.back()->sequence_number(),
-                     (*iter_cached_packet)->rtp_struct->sequence_number())) {
+                     (*iter_cached_packet)->seq)) {
         break;
       }
     }
@@ -574,7 +584,7 @@ void UlpFecDecoder::Flush(
 }
 
 void UlpFecDecoder::RcoverPackets() {
-  uint16_t last_seq = cached_packets_.back()->rtp_struct->sequence_number();
+  uint16_t last_seq = cached_packets_.back()->seq;
   std::vector<CachedPacket*> fec_packets;
   for (auto iter_fec_packet = cached_packets_.begin();
        iter_fec_packet != cached_packets_.end(); ++iter_fec_packet) {
@@ -610,8 +620,7 @@ void UlpFecDecoder::RcoverPackets() {
       }
       for (auto iter_cached_packet = cached_packets_.begin();
            iter_cached_packet != cached_packets_.end(); ++iter_cached_packet) {
-        if ((*iter_cached_packet)->rtp_struct->sequence_number() ==
-            iter_protected_seq->first) {
+        if ((*iter_cached_packet)->seq == iter_protected_seq->first) {
           iter_protected_seq->second = true;
           (*iter_fec_packet)
               ->media_packets.push_back((*iter_cached_packet).get());
@@ -630,8 +639,7 @@ void UlpFecDecoder::RcoverPackets() {
     }
     uint16_t seq_will_recover = no_received_seqs.front();
     if (IsSeqBefore(seq_will_recover, seq_last_output_) ||
-        IsSeqAfter(cached_packets_.back()->rtp_struct->sequence_number(),
-                   seq_will_recover)) {
+        IsSeqAfter(cached_packets_.back()->seq, seq_will_recover)) {
       continue;
     }
     std::unique_ptr<CachedPacket> recovered_packet = FecRecoverPacket(
@@ -639,22 +647,19 @@ void UlpFecDecoder::RcoverPackets() {
     if (!recovered_packet) {
       continue;
     }
-    if (recovered_packet->rtp_struct->sequence_number() != seq_will_recover) {
+    if (recovered_packet->seq != seq_will_recover) {
       continue;
     }
     QOSRTP_LOG(Trace, "Recover seq: %hu, from fec seq: %hu",
-               recovered_packet->rtp_struct->sequence_number(),
-               (*iter_fec_packet)->rtp_struct->sequence_number());
+               recovered_packet->seq, (*iter_fec_packet)->seq);
     bool need_insert = true;
     auto pos_insert = cached_packets_.begin();
     for (; pos_insert != cached_packets_.end(); ++pos_insert) {
-      if ((*pos_insert)->rtp_struct->sequence_number() ==
-          recovered_packet->rtp_struct->sequence_number()) {
+      if ((*pos_insert)->seq == recovered_packet->seq) {
         need_insert = false;
         break;
       }
-      if (IsSeqBefore(recovered_packet->rtp_struct->sequence_number(),
-                      (*pos_insert)->rtp_struct->sequence_number())) {
+      if (IsSeqBefore(recovered_packet->seq, (*pos_insert)->seq)) {
         break;
       }
     }
@@ -733,16 +738,19 @@ std::unique_ptr<UlpFecDecoder::CachedPacket> UlpFecDecoder::FecRecoverPacket(
       RtpPacket::kFixedBufferLength);
   std::unique_ptr<UlpFecDecoder::CachedPacket> ret_packet =
       std::make_unique<UlpFecDecoder::CachedPacket>();
-  ret_packet->rtp_struct = RtpPacket::Create();
-  std::unique_ptr<Result> result = ret_packet->rtp_struct->StorePacket(
-      recovered_rtp_buffer->Get(), recovered_rtp_buffer->size());
-  if (!result->ok()) {
+  std::unique_ptr<RtpPacketImpl> recovered_packet =
+      std::make_unique<RtpPacketImpl>();
+  Status result = recovered_packet->Store(recovered_rtp_buffer->Get(),
+                                          recovered_rtp_buffer->size());
+  if (!result.ok()) {
     QOSRTP_LOG(
         Error,
         "Failed to build rtp when recovering packet from fec, because: %s",
-        result->description().c_str());
+        result.description());
     return nullptr;
   }
+  ret_packet->seq = recovered_packet->sequence_number();
+  ret_packet->rtp_struct = std::move(recovered_packet);
   if (!ret_packet->rtp_struct->GetPayloadBuffer()) {
     QOSRTP_LOG(Error, "Get a empty rtp when recovering packet from fec");
     return nullptr;
@@ -768,13 +776,12 @@ void UlpFecDecoder::CachePackets(
     bool need_insert = true;
     auto pos_insert = cached_packets_.begin();
     for (; pos_insert != cached_packets_.end(); ++pos_insert) {
-      if ((*pos_insert)->rtp_struct->sequence_number() ==
-          (*iter_received_packet)->sequence_number()) {
+      if ((*pos_insert)->seq == (*iter_received_packet)->sequence_number()) {
         need_insert = false;
         break;
       }
       if (IsSeqBefore((*iter_received_packet)->sequence_number(),
-                      (*pos_insert)->rtp_struct->sequence_number())) {
+                      (*pos_insert)->seq)) {
         break;
       }
     }
@@ -783,6 +790,7 @@ void UlpFecDecoder::CachePackets(
     }
     std::unique_ptr<CachedPacket> new_cached_packet =
         std::make_unique<CachedPacket>();
+    new_cached_packet->seq = (*iter_received_packet)->sequence_number();
     new_cached_packet->rtp_buffer = (*iter_received_packet)->LoadPacket();
     new_cached_packet->rtp_struct = std::move((*iter_received_packet));
     new_cached_packet->DecodeFecInfo(config_->payload_type());
@@ -794,6 +802,7 @@ void UlpFecDecoder::CachePackets(
 UlpFecDecoder::CachedPacket::CachedPacket()
     : rtp_struct(nullptr),
       rtp_buffer(nullptr),
+      seq(0),
       is_fec(false),
       invalid_fec(false) {}
 
@@ -3,6 +3,8 @@
 
 #include <map>
 
+#include "../utils/status.h"
+
 namespace qosrtp {
 // FEC Level 0 Header, 10 bytes.
 //    0                   1                   2                   3
@@ -48,6 +50,13 @@ class UlpFecEncoder : public FecEncoder {
       ImportantPacketsProtectionMethod method_protect_important_packets,
       uint8_t protection_factor, FecMaskType fec_mask_type,
       std::vector<std::unique_ptr<RtpPacket>>& fec_packets) override;
+  // Encode adapts the status returned from here to the exported Result.
+  Status Protect(
+      const std::vector<const RtpPacket*>& protected_packets,
+      uint32_t num_important_packets,
+      ImportantPacketsProtectionMethod method_protect_important_packets,
+      uint8_t protection_factor, FecMaskType fec_mask_type,
+      std::vector<std::unique_ptr<RtpPacket>>& fec_packets);
 
  private:
   struct RtpPacketData {
@@ -138,6 +147,8 @@ class UlpFecDecoder : public FecDecoder {
     void DecodeFecInfo(uint8_t fec_pt);
     std::unique_ptr<RtpPacket> rtp_struct;
     std::unique_ptr<DataBuffer> rtp_buffer;
+    // Copy of rtp_struct->sequence_number(), read in the search loops.
+    uint16_t seq;
     bool is_fec;
     std::map<uint16_t, bool> map_protected_seq_received;
     std::vector<const CachedPacket*> media_packets;
@@ -0,0 +1,118 @@
+#include "xr.h"
+
+#include "../utils/byte_io.h"
+
+using namespace qosrtp;
+using namespace qosrtp::rtcp;
+
+ExtendedReports::ExtendedReports() : has_rrtr_(false), rrtr_ntp_() {}
+
+ExtendedReports::~ExtendedReports() = default;
+
+Status ExtendedReports::AddDlrrItem(const ReceiveTimeInfo& item) {
+  if (dlrr_items_.size() >= kMaxNumberOfDlrrItems) {
+    return Status::Error("Max dlrr items reached.");
+  }
+  dlrr_items_.push_back(item);
+  return Status::Ok();
+}
+
+uint32_t ExtendedReports::BlockLength() const {
+  uint32_t length = kHeaderLength + sizeof(uint32_t);
+  if (has_rrtr_) {
+    length += kRrtrBlockLength;
+  }
+  if (!dlrr_items_.empty()) {
+    length += kBlockHeaderLength + dlrr_items_.size() * kDlrrItemLength;
+  }
+  return length;
+}
+
+Status ExtendedReports::LoadPacket(uint8_t* packet, uint32_t* pos,
+                                   uint32_t max_length) const {
+  if (max_length < (*pos) + BlockLength()) {
+    return Status::Error(
+        "The remaining buffer space is less than the length "
+        "of the loaded packet");
+  }
+  RtcpPacket::CreateHeader(0, kPacketType,
+                           (BlockLength() - kHeaderLength) / sizeof(uint32_t),
+                           packet, pos);
+  ByteWriter<uint32_t>::WriteBigEndian(&packet[*pos], sender_ssrc());
+  *pos += sizeof(uint32_t);
+  if (has_rrtr_) {
+    packet[*pos + 0] = kRrtrBlockType;
+    packet[*pos + 1] = 0;
+    ByteWriter<uint16_t>::WriteBigEndian(
+        &packet[*pos + 2], (kRrtrBlockLength - kBlockHeaderLength) / 4);
+    ByteWriter<uint64_t>::WriteBigEndian(&packet[*pos + 4],
+                                         (uint64_t)rrtr_ntp_);
+    *pos += kRrtrBlockLength;
+  }
+  if (!dlrr_items_.empty()) {
+    packet[*pos + 0] = kDlrrBlockType;
+    packet[*pos + 1] = 0;
+    ByteWriter<uint16_t>::WriteBigEndian(
+        &packet[*pos + 2], dlrr_items_.size() * kDlrrItemLength / 4);
+    *pos += kBlockHeaderLength;
+    for (const ReceiveTimeInfo& item : dlrr_items_) {
+      ByteWriter<uint32_t>::WriteBigEndian(&packet[*pos + 0], item.ssrc);
+      ByteWriter<uint32_t>::WriteBigEndian(&packet[*pos + 4], item.last_rr);
+      ByteWriter<uint32_t>::WriteBigEndian(&packet[*pos + 8],
+                                           item.delay_since_last_rr);
+      *pos += kDlrrItemLength;
+    }
+  }
+  return Status::Ok();
+}
+
+Status ExtendedReports::StorePacket(const CommonHeader& packet) {
+  if (packet.type() != kPacketType) {
+    return Status::Error("The type of rtcp is not extended reports.");
+  }
+  if (packet.payload_size_bytes() < sizeof(uint32_t)) {
+    return Status::Error("Packet is too small to contain the ssrc.");
+  }
+  const uint8_t* const payload = packet.payload();
+  SetSenderSsrc(ByteReader<uint32_t>::ReadBigEndian(payload));
+  has_rrtr_ = false;
+  rrtr_ntp_.Reset();
+  dlrr_items_.clear();
+  uint32_t pos = sizeof(uint32_t);
+  while (pos + kBlockHeaderLength <= packet.payload_size_bytes()) {
+    uint8_t block_type = payload[pos];
+    uint32_t block_length =
+        4 * ByteReader<uint16_t>::ReadBigEndian(&payload[pos + 2]);
+    pos += kBlockHeaderLength;
+    if (pos + block_length > packet.payload_size_bytes()) {
+      return Status::Error("Report block exceeds the packet.");
+    }
+    switch (block_type) {
+      case kRrtrBlockType:
+        if (kRrtrBlockLength - kBlockHeaderLength != block_length) {
+          return Status::Error("Invalid rrtr block length.");
+        }
+        has_rrtr_ = true;
+        rrtr_ntp_.Set(ByteReader<uint32_t>::ReadBigEndian(&payload[pos]),
+                      ByteReader<uint32_t>::ReadBigEndian(&payload[pos + 4]));
+        break;
+      case kDlrrBlockType:
+        if (0 != (block_length % kDlrrItemLength)) {
+          return Status::Error("Invalid dlrr block length.");
+        }
+        for (uint32_t offset = 0; offset < block_length;
+             offset += kDlrrItemLength) {
+          const uint8_t* item = &payload[pos + offset];
+          dlrr_items_.push_back(
+              {ByteReader<uint32_t>::ReadBigEndian(&item[0]),
+               ByteReader<uint32_t>::ReadBigEndian(&item[4]),
+               ByteReader<uint32_t>::ReadBigEndian(&item[8])});
+        }
+        break;
+      default:
+        break;
+    }
+    pos += block_length;
+  }
+  return Status::Ok();
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+#include <vector>
+
+#include "../utils/ntp_time.h"
+#include "../utils/status.h"
+#include "common_header.h"
+#include "rtcp_packet.h"
+
+namespace qosrtp {
+namespace rtcp {
+// Extended Reports (XR) (RFC 3611), only the blocks used to measure the
+// round trip time of a receiver that does not send sender reports.
+//
+//     0                   1                   2                   3
+//     0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |V=2|P|reserved |   PT=XR=207   |             length            |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  0 |                              SSRC                             |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  4 :                         report blocks                         :
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//
+// Receiver Reference Time Report Block (RRTR).
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |     BT=4      |   reserved    |       block length = 2        |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |              NTP timestamp, most significant word             |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |             NTP timestamp, least significant word             |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//
+// DLRR Report Block, one sub-block per receiver.
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |     BT=5      |   reserved    |         block length          |
+//    +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//    |                 SSRC_1 (SSRC of first receiver)               | sub-
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ block
+//    |                         last RR (LRR)                         |   1
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |                   delay since last RR (DLRR)                  |
+//    +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+//
+// Blocks of other types are skipped when parsing.
+class ExtendedReports : public RtcpPacket {
+ public:
+  static constexpr uint8_t kPacketType = 207;
+  static constexpr size_t kMaxNumberOfDlrrItems = 50;
+  struct ReceiveTimeInfo {
+    uint32_t ssrc;
+    uint32_t last_rr;
+    uint32_t delay_since_last_rr;  // units of 1/65536 seconds
+  };
+
+  ExtendedReports();
+  virtual ~ExtendedReports() override;
+
+  // StorePacket assumes header is already parsed and validated.
+  Status StorePacket(const CommonHeader& packet);
+
+  void SetRrtr(NtpTime ntp) {
+    has_rrtr_ = true;
+    rrtr_ntp_ = ntp;
+  }
+  Status AddDlrrItem(const ReceiveTimeInfo& item);
+
+  bool has_rrtr() const { return has_rrtr_; }
+  NtpTime rrtr_ntp() const { return rrtr_ntp_; }
+  const std::vector<ReceiveTimeInfo>& dlrr_items() const {
+    return dlrr_items_;
+  }
+
+  virtual uint32_t BlockLength() const override;
+
+  virtual Status LoadPacket(
+      uint8_t* packet, uint32_t* pos, uint32_t max_length) const override;
+
+ private:
+  static constexpr uint8_t kRrtrBlockType = 4;
+  static constexpr uint8_t kDlrrBlockType = 5;
+  static constexpr uint32_t kBlockHeaderLength = 4;
+  static constexpr uint32_t kRrtrBlockLength = 12;
+  static constexpr uint32_t kDlrrItemLength = 12;
+  bool has_rrtr_;
+  NtpTime rrtr_ntp_;
+  std::vector<ReceiveTimeInfo> dlrr_items_;
+};
+}  // namespace rtcp
+}  // namespace qosrtp
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "media_session.h"
 
 #include "../include/log.h"
+#include "../rtp_rtcp/rtp_packetizer.h"
+#include "../utils/time_utils.h"
+
+#include <algorithm>
 
 namespace qosrtp {
 std::unique_ptr<Result> MediaSession::Initialize(
@@ -33,11 +37,23 @@ std::unique_ptr<Result> MediaSession::Initialize(
     rtp_sender_config->local_ssrc = config_->ssrc_media_local();
     rtp_sender_config->rtp_clock_rate_hz = config_->rtp_clock_rate_hz_local();
     rtp_sender_config->rtp_payload_types = config_->rtp_payload_types_local();
+    rtp_sender_config->media_priority =
+        (MediaType::kAudio == config_->media_type_local())
+            ? PacketPriority::kAudio
+            : PacketPriority::kVideo;
+    rtp_sender_config->fec_payload_type = config_->fec_payload_type_local();
+    rtp_sender_config->auto_sequencing = config_->auto_sequencing_enabled();
     if (config_->rtx_config_local()) {
       rtp_sender_config->rtx_enabled = true;
       rtp_sender_config->rtx_ssrc = config_->rtx_config_local()->ssrc();
       rtp_sender_config->max_cache_seq_difference =
           config_->rtx_config_local()->max_cache_seq_difference();
+      rtp_sender_config->min_history_duration_ms =
+          config_->rtx_config_local()->history_min_duration_ms();
+      rtp_sender_config->max_history_bytes =
+          config_->rtx_config_local()->history_max_bytes();
+      rtp_sender_config->max_rtx_bitrate_percent =
+          config_->rtx_config_local()->max_bitrate_percent();
       rtp_sender_config->map_rtx_payload_type =
           config_->rtx_config_local()->map_rtx_payload_type();
     }
@@ -85,6 +101,18 @@ std::unique_ptr<Result> MediaSession::Initialize(
         config_->rtp_payload_types_remote();
     rtp_receiver_config->max_cache_duration_ms =
         config_->max_cache_duration_ms();
+    rtp_receiver_config->expected_bitrate_bps =
+        config_->expected_receive_bitrate_bps();
+    rtp_receiver_config->max_cache_bytes = config_->receive_cache_max_bytes();
+    rtp_receiver_config->min_target_delay_ms =
+        config_->jitter_buffer_min_delay_ms();
+    rtp_receiver_config->max_target_delay_ms =
+        config_->jitter_buffer_max_delay_ms();
+    rtp_receiver_config->frame_assembly_enabled =
+        config_->frame_assembly_enabled();
+    rtp_receiver_config->video_codec = config_->video_codec();
+    rtp_receiver_config->catch_up_threshold_ms =
+        config_->catch_up_threshold_ms();
     if (config_->rtx_config_remote()) {
       rtp_receiver_config->rtx_enabled = true;
       rtp_receiver_config->rtx_ssrc = config_->rtx_config_remote()->ssrc();
@@ -94,7 +122,8 @@ std::unique_ptr<Result> MediaSession::Initialize(
           config_->rtx_config_remote()->map_rtx_payload_type();
     }
     rtp_receiver_ = std::make_unique<RtpReceiver>();
-    result = rtp_receiver_->Initialize(this, std::move(rtp_receiver_config));
+    result = rtp_receiver_->Initialize(worker_thread_, this,
+                                       std::move(rtp_receiver_config));
     if (!result->ok()) {
       QOSRTP_LOG(Error, "Failed to initialize rtp receiver, because: %s",
                  result->description().c_str());
@@ -125,6 +154,57 @@ void MediaSession::SendRtpPacket(std::unique_ptr<RtpPacket> pkt) {
   rtp_sender_->SendRtp(std::move(pkt));
 }
 
+void MediaSession::SendRtpPackets(
+    std::vector<std::unique_ptr<RtpPacket>> packets,
+    uint64_t capture_time_utc_ms, const FrameSendOptions& options) {
+  if (!initialized_.load()) return;
+  if (MediaTransmissionDirection::kRecvOnly == config_->direction()) return;
+  // The queue delay counts from here.
+  uint64_t enqueue_time_us = SteadyTimeMicros();
+  if (!signal_thread_->IsCurrent()) {
+    signal_thread_->PushTask(CallableWrapper::Wrap(
+        &MediaSession::SendRtpPacketsInternal, this, std::move(packets),
+        capture_time_utc_ms, options, enqueue_time_us));
+    return;
+  }
+  SendRtpPacketsInternal(std::move(packets), capture_time_utc_ms, options,
+                         enqueue_time_us);
+}
+
+void MediaSession::SendRtpPacketsInternal(
+    std::vector<std::unique_ptr<RtpPacket>> packets,
+    uint64_t capture_time_utc_ms, FrameSendOptions options,
+    uint64_t enqueue_time_us) {
+  rtp_sender_->SendRtpPackets(std::move(packets), capture_time_utc_ms,
+                              options, enqueue_time_us);
+}
+
+std::unique_ptr<Result> MediaSession::SendFrame(
+    std::unique_ptr<DataBuffer> frame, uint8_t payload_type,
+    RtpPacketization packetization, uint16_t mtu,
+    uint64_t capture_time_utc_ms, const FrameSendOptions& options) {
+  if (!initialized_.load())
+    return Result::Create(-1, "The media session is not initialized");
+  if (MediaTransmissionDirection::kRecvOnly == config_->direction())
+    return Result::Create(-1, "The media session does not send");
+  if (!config_->auto_sequencing_enabled())
+    return Result::Create(-1, "Frames are sent with auto sequencing only");
+  const std::vector<uint8_t>& payload_types =
+      config_->rtp_payload_types_local();
+  if (std::find(payload_types.begin(), payload_types.end(), payload_type) ==
+      payload_types.end()) {
+    return Result::Create(-1, "The payload type is not a local one");
+  }
+  // Packetized on the calling thread, the slices share the frame.
+  std::vector<std::unique_ptr<RtpPacket>> packets;
+  Status status = RtpPacketizer::Packetize(
+      packetization, std::shared_ptr<const DataBuffer>(std::move(frame)),
+      payload_type, config_->ssrc_media_local(), mtu, packets);
+  if (!status.ok()) return status.ToResult();
+  SendRtpPackets(std::move(packets), capture_time_utc_ms, options);
+  return Result::Create();
+}
+
 void MediaSession::SendBye() {
   if (!initialized_.load()) return;
   rtcp_sender_->SendBye();
@@ -141,6 +221,27 @@ void MediaSession::NotifyNackReceived(
   rtp_sender_->SendRtx(packet_seqs);
 }
 
+void MediaSession::NotifyRttUpdated(uint32_t rtt_ms) {
+  if (!initialized_.load()) return;
+  if (MediaTransmissionDirection::kRecvOnly != config_->direction()) {
+    rtp_sender_->SetRtt(rtt_ms);
+  }
+  if (MediaTransmissionDirection::kSendOnly != config_->direction()) {
+    rtp_receiver_->SetRtt(rtt_ms);
+  }
+}
+
+void MediaSession::NotifyPliReceived() {
+  if (!initialized_.load()) return;
+  if (MediaTransmissionDirection::kRecvOnly == config_->direction()) return;
+  if (!signal_thread_->IsCurrent()) {
+    signal_thread_->PushTask(
+        CallableWrapper::Wrap(&MediaSession::NotifyPliReceived, this));
+    return;
+  }
+  config_->callback()->OnKeyFrameRequested();
+}
+
 bool MediaSession::HasSentRtp() {
   if (!initialized_.load()) return false;
   if (!has_sent_rtp_.load() &&
@@ -180,6 +281,83 @@ std::unique_ptr<RemoteSenderInfo> MediaSession::GetRemoteSenderInfo() {
   return remote_sender_info;
 }
 
+std::unique_ptr<Result> MediaSession::GetReceiveStatistics(
+    MediaReceiveStatistics& statistics) {
+  if (!initialized_.load() || (nullptr == rtp_receiver_)) {
+    return Result::Create(-1, "The media session does not receive");
+  }
+  std::unique_ptr<RtpReceiverStatistics> receiver_statistics =
+      rtp_receiver_->GetRtpReceiverStatistics();
+  if (nullptr == receiver_statistics) {
+    return Result::Create(-1, "No rtp packet has been received yet");
+  }
+  statistics.remote_ssrc = receiver_statistics->remote_ssrc;
+  statistics.cumulative_loss = receiver_statistics->cumulative_loss;
+  statistics.extended_seq_num = receiver_statistics->extended_seq_num;
+  statistics.first_extended_seq_num =
+      receiver_statistics->first_extended_seq_num;
+  statistics.interarrival_jitter = receiver_statistics->interarrival_jitter;
+  statistics.suppressed_nacks = receiver_statistics->suppressed_nacks;
+  statistics.nacked_seqs = receiver_statistics->nacked_seqs;
+  statistics.spurious_nacks = receiver_statistics->spurious_nacks;
+  statistics.evicted_frames = receiver_statistics->evicted_frames;
+  statistics.evicted_packets = receiver_statistics->evicted_packets;
+  statistics.evicted_bytes = receiver_statistics->evicted_bytes;
+  statistics.early_released_packets =
+      receiver_statistics->early_released_packets;
+  statistics.catch_ups = receiver_statistics->catch_ups;
+  statistics.catch_up_dropped_packets =
+      receiver_statistics->catch_up_dropped_packets;
+  statistics.key_frame_requests = receiver_statistics->key_frame_requests;
+  const LossPatternStatistics& loss_pattern =
+      receiver_statistics->loss_pattern;
+  static_assert(MediaReceiveStatistics::kNbLossPatternBuckets ==
+                    LossPatternStatistics::kNbBuckets,
+                "The loss pattern buckets differ");
+  statistics.burst_lengths = loss_pattern.burst_lengths;
+  statistics.gap_lengths = loss_pattern.gap_lengths;
+  statistics.reorder_depths = loss_pattern.reorder_depths;
+  statistics.max_reorder_depth = loss_pattern.max_reorder_depth;
+  statistics.duplicates = loss_pattern.duplicates;
+  statistics.late_arrivals = loss_pattern.late_arrivals;
+  statistics.gap_to_burst_probability = loss_pattern.gap_to_burst_probability;
+  statistics.burst_to_gap_probability = loss_pattern.burst_to_gap_probability;
+  statistics.gap_loss_density = loss_pattern.gap_loss_density;
+  statistics.burst_loss_density = loss_pattern.burst_loss_density;
+  return Result::Create();
+}
+
+std::unique_ptr<Result> MediaSession::GetSendStatistics(
+    MediaSendStatistics& statistics) {
+  if (!initialized_.load() || (nullptr == rtp_sender_)) {
+    return Result::Create(-1, "The media session does not send");
+  }
+  std::unique_ptr<RtpSenderStatistics> sender_statistics =
+      rtp_sender_->GetRtpSenderStatistics();
+  statistics.history_hits = sender_statistics->history_hits;
+  statistics.history_misses = sender_statistics->history_misses;
+  statistics.history_packets = sender_statistics->history_packets;
+  statistics.history_bytes = sender_statistics->history_bytes;
+  statistics.history_duration_ms = sender_statistics->history_duration_ms;
+  statistics.rtx_packets = sender_statistics->rtx_packets;
+  statistics.rtx_bytes = sender_statistics->rtx_bytes;
+  statistics.rtx_suppressed = sender_statistics->rtx_suppressed;
+  statistics.rtx_rate_limited = sender_statistics->rtx_rate_limited;
+  statistics.rtx_expired = sender_statistics->rtx_expired;
+  statistics.rtx_dropped = sender_statistics->rtx_dropped;
+  statistics.frames_dropped_expired =
+      sender_statistics->frames_dropped_expired;
+  statistics.packets_dropped_expired =
+      sender_statistics->packets_dropped_expired;
+  statistics.packets_dropped_droppable =
+      sender_statistics->packets_dropped_droppable;
+  static_assert(MediaSendStatistics::kNbQueueDelayBuckets ==
+                    SendQueueStatistics::kNbQueueDelayBuckets,
+                "The queue delay buckets differ");
+  statistics.queue_delay_histogram = sender_statistics->queue_delay_histogram;
+  return Result::Create();
+}
+
 std::unique_ptr<LocalSenderInfo> MediaSession::GetLocalSenderInfo() {
   if (!initialized_.load() || !has_sent_rtp_.load()) return nullptr;
   std::unique_ptr<LocalSenderInfo> local_sender_info =
@@ -191,6 +369,11 @@ std::unique_ptr<LocalSenderInfo> MediaSession::GetLocalSenderInfo() {
   return local_sender_info;
 }
 
+bool MediaSession::GetRemoteRrtrInfo(uint32_t& lrr, uint32_t& dlrr) {
+  if (!initialized_.load()) return false;
+  return rtcp_receiver_->GetRrtrInfo(lrr, dlrr);
+}
+
 void MediaSession::NotifyLossPacketSeqsForNack(
     const std::vector<uint16_t>& loss_packet_seqs) {
   if (!initialized_.load()) return;
@@ -208,6 +391,26 @@ void MediaSession::OnRtpPacket(
   config_->callback()->OnRtpPacket(std::move(packets));
 }
 
+void MediaSession::OnRtpFrames(
+    std::vector<std::unique_ptr<RtpFrame>> frames) {
+  if (!initialized_.load()) return;
+  if (!signal_thread_->IsCurrent()) {
+    signal_thread_->PushTask(CallableWrapper::Wrap(&MediaSession::OnRtpFrames,
+                                                   this, std::move(frames)));
+    return;
+  }
+  config_->callback()->OnRtpFrames(std::move(frames));
+}
+
+bool MediaSession::IsKeyFrameStart(const RtpPacket& packet) {
+  return config_->callback()->IsKeyFrameStart(&packet);
+}
+
+void MediaSession::RequestKeyFrame() {
+  if (!initialized_.load()) return;
+  rtcp_sender_->SendPli();
+}
+
 
 MediaSession::MediaSession(const std::string& cname)
     : config_(nullptr),
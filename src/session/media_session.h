@@ -24,7 +24,19 @@ class MediaSession : public RtcpReceiverCallback,
                                      RtpRtcpTranceiver* rtp_rtcp_tranceiver,
                                      RtpRtcpRouter* rtp_rtcp_router);
   void SendRtpPacket(std::unique_ptr<RtpPacket> pkt);
+  void SendRtpPackets(std::vector<std::unique_ptr<RtpPacket>> packets,
+                      uint64_t capture_time_utc_ms,
+                      const FrameSendOptions& options);
+  std::unique_ptr<Result> SendFrame(std::unique_ptr<DataBuffer> frame,
+                                    uint8_t payload_type,
+                                    RtpPacketization packetization,
+                                    uint16_t mtu,
+                                    uint64_t capture_time_utc_ms,
+                                    const FrameSendOptions& options);
   void SendBye();
+  std::unique_ptr<Result> GetReceiveStatistics(
+      MediaReceiveStatistics& statistics);
+  std::unique_ptr<Result> GetSendStatistics(MediaSendStatistics& statistics);
 
   uint32_t GetLocalSsrc() { return config_->ssrc_media_local(); }
 
@@ -32,6 +44,9 @@ class MediaSession : public RtcpReceiverCallback,
   virtual void NotifyByeReceived() override;
   virtual void NotifyNackReceived(
       const std::vector<uint16_t>& packet_seqs) override;
+  virtual void NotifyRttUpdated(uint32_t rtt_ms) override;
+  // will run on signal thread
+  virtual void NotifyPliReceived() override;
 
   /* RtcpSenderCallback override*/
   virtual bool HasSentRtp() override;
@@ -39,6 +54,7 @@ class MediaSession : public RtcpReceiverCallback,
   virtual bool HasReceivedBye() override;
   virtual std::unique_ptr<RemoteSenderInfo> GetRemoteSenderInfo() override;
   virtual std::unique_ptr<LocalSenderInfo> GetLocalSenderInfo() override;
+  virtual bool GetRemoteRrtrInfo(uint32_t& lrr, uint32_t& dlrr) override;
 
   /* RtpReceiverCallback override*/
   virtual void NotifyLossPacketSeqsForNack(
@@ -46,8 +62,18 @@ class MediaSession : public RtcpReceiverCallback,
   // will run on signal thread
   virtual void OnRtpPacket(
       std::vector<std::unique_ptr<RtpPacket>> packets) override;
+  // will run on signal thread
+  virtual void OnRtpFrames(
+      std::vector<std::unique_ptr<RtpFrame>> frames) override;
+  virtual bool IsKeyFrameStart(const RtpPacket& packet) override;
+  virtual void RequestKeyFrame() override;
 
  private:
+  // Runs on the signal thread.
+  void SendRtpPacketsInternal(std::vector<std::unique_ptr<RtpPacket>> packets,
+                              uint64_t capture_time_utc_ms,
+                              FrameSendOptions options,
+                              uint64_t enqueue_time_us);
   const MediaSessionConfig* config_;
   RtpRtcpTranceiver* rtp_rtcp_tranceiver_;
   RtpRtcpRouter* rtp_rtcp_router_;
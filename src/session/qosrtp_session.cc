@@ -52,6 +52,15 @@ MediaSessionCallback::MediaSessionCallback() = default;
 
 MediaSessionCallback::~MediaSessionCallback() = default;
 
+void MediaSessionCallback::OnRtpFrames(
+    std::vector<std::unique_ptr<RtpFrame>> /*frames*/) {}
+
+bool MediaSessionCallback::IsKeyFrameStart(const RtpPacket* /*packet*/) {
+  return true;
+}
+
+void MediaSessionCallback::OnKeyFrameRequested() {}
+
 QosrtpSession ::QosrtpSession() = default;
 
 QosrtpSession ::~QosrtpSession() = default;
\ No newline at end of file
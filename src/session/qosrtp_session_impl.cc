@@ -57,7 +57,12 @@ void TransportAddressImpl::SaveToSockAddr(sockaddr* sock_addr) const {
   }
 }
 
-RtxConfigImpl::RtxConfigImpl() : ssrc_(0), max_cache_seq_difference_(0) {}
+RtxConfigImpl::RtxConfigImpl()
+    : max_cache_seq_difference_(0),
+      history_min_duration_ms_(0),
+      history_max_bytes_(0),
+      max_bitrate_percent_(0),
+      ssrc_(0) {}
 
 RtxConfigImpl::~RtxConfigImpl() = default;
 
@@ -85,6 +90,16 @@ void RtxConfigImpl::DeleteRtxAndAssociatedPayloadType(uint8_t rtx_pt) {
 
 void RtxConfigImpl::ClearRtxPayload() { map_rtx_payload_type_.clear(); }
 
+void RtxConfigImpl::SetHistoryBounds(uint16_t min_duration_ms,
+                                     uint32_t max_bytes) {
+  history_min_duration_ms_ = min_duration_ms;
+  history_max_bytes_ = max_bytes;
+}
+
+void RtxConfigImpl::SetMaxBitrateRatio(uint16_t max_percent) {
+  max_bitrate_percent_ = max_percent;
+}
+
 const std::map<uint8_t, uint8_t>& RtxConfigImpl::map_rtx_payload_type() const {
   return map_rtx_payload_type_;
 }
@@ -93,6 +108,18 @@ uint16_t RtxConfigImpl::max_cache_seq_difference() const {
   return max_cache_seq_difference_;
 }
 
+uint16_t RtxConfigImpl::history_min_duration_ms() const {
+  return history_min_duration_ms_;
+}
+
+uint32_t RtxConfigImpl::history_max_bytes() const {
+  return history_max_bytes_;
+}
+
+uint16_t RtxConfigImpl::max_bitrate_percent() const {
+  return max_bitrate_percent_;
+}
+
 uint32_t RtxConfigImpl::ssrc() const { return ssrc_; }
 
 MediaSessionConfigImpl::MediaSessionConfigImpl()
@@ -101,11 +128,21 @@ MediaSessionConfigImpl::MediaSessionConfigImpl()
       rtp_clock_rate_hz_remote_(0),
       ssrc_media_local_(0),
       ssrc_media_remote_(0),
-      max_cache_duration_ms_(0),
       direction_(MediaTransmissionDirection::kSendRecv),
       rtx_config_local_(nullptr),
       rtx_config_remote_(nullptr),
-      callback_(nullptr) {}
+      callback_(nullptr),
+      max_cache_duration_ms_(0),
+      expected_receive_bitrate_bps_(0),
+      receive_cache_max_bytes_(0),
+      jitter_buffer_min_delay_ms_(0),
+      jitter_buffer_max_delay_ms_(0),
+      frame_assembly_enabled_(false),
+      video_codec_(RtpVideoCodec::kNone),
+      catch_up_threshold_ms_(0),
+      media_type_local_(MediaType::kVideo),
+      fec_payload_type_local_(-1),
+      auto_sequencing_enabled_(false) {}
 
 MediaSessionConfigImpl::~MediaSessionConfigImpl() = default;
 
@@ -183,6 +220,11 @@ std::unique_ptr<Result> MediaSessionConfigImpl::Configure(
     rtx_config_local_ = RtxConfig::Create();
     rtx_config_local_->Configure(rtx_config_local->max_cache_seq_difference(),
                                  rtx_config_local->ssrc());
+    rtx_config_local_->SetHistoryBounds(
+        rtx_config_local->history_min_duration_ms(),
+        rtx_config_local->history_max_bytes());
+    rtx_config_local_->SetMaxBitrateRatio(
+        rtx_config_local->max_bitrate_percent());
     const std::map<uint8_t, uint8_t>& map_rtx_payload_type =
         rtx_config_local->map_rtx_payload_type();
     for (auto iter = map_rtx_payload_type.begin();
@@ -218,6 +260,55 @@ std::unique_ptr<Result> MediaSessionConfigImpl::Configure(
   return Result::Create();
 }
 
+void MediaSessionConfigImpl::SetExpectedReceiveBitrate(uint32_t bitrate_bps) {
+  expected_receive_bitrate_bps_ = bitrate_bps;
+}
+
+void MediaSessionConfigImpl::SetReceiveCacheByteBudget(uint32_t max_bytes) {
+  receive_cache_max_bytes_ = max_bytes;
+}
+
+std::unique_ptr<Result> MediaSessionConfigImpl::SetJitterBufferDelayBounds(
+    uint16_t min_delay_ms, uint16_t max_delay_ms) {
+  if ((0 == max_delay_ms) || (min_delay_ms > max_delay_ms)) {
+    return Result::Create(
+        -1, "max_delay_ms must be positive and not less than min_delay_ms");
+  }
+  jitter_buffer_min_delay_ms_ = min_delay_ms;
+  jitter_buffer_max_delay_ms_ = max_delay_ms;
+  return Result::Create();
+}
+
+void MediaSessionConfigImpl::EnableFrameAssembly(bool enabled) {
+  frame_assembly_enabled_ = enabled;
+}
+
+void MediaSessionConfigImpl::SetVideoCodec(RtpVideoCodec codec) {
+  video_codec_ = codec;
+}
+
+void MediaSessionConfigImpl::SetCatchUpThreshold(uint32_t threshold_ms) {
+  catch_up_threshold_ms_ = threshold_ms;
+}
+
+void MediaSessionConfigImpl::SetLocalMediaType(MediaType type) {
+  media_type_local_ = type;
+}
+
+std::unique_ptr<Result> MediaSessionConfigImpl::SetLocalFecPayloadType(
+    uint8_t fec_pt) {
+  if (fec_pt > 0x7F) {
+    return Result::Create(-1,
+                          "The pt value must be less than or equal to 0x7F");
+  }
+  fec_payload_type_local_ = fec_pt;
+  return Result::Create();
+}
+
+void MediaSessionConfigImpl::EnableAutoSequencing(bool enabled) {
+  auto_sequencing_enabled_ = enabled;
+}
+
 uint32_t MediaSessionConfigImpl::ssrc_media_local() const {
   return ssrc_media_local_;
 }
@@ -260,6 +351,46 @@ uint16_t MediaSessionConfigImpl::max_cache_duration_ms() const {
   return max_cache_duration_ms_;
 }
 
+uint32_t MediaSessionConfigImpl::expected_receive_bitrate_bps() const {
+  return expected_receive_bitrate_bps_;
+}
+
+uint32_t MediaSessionConfigImpl::receive_cache_max_bytes() const {
+  return receive_cache_max_bytes_;
+}
+
+uint16_t MediaSessionConfigImpl::jitter_buffer_min_delay_ms() const {
+  return jitter_buffer_min_delay_ms_;
+}
+
+uint16_t MediaSessionConfigImpl::jitter_buffer_max_delay_ms() const {
+  return jitter_buffer_max_delay_ms_;
+}
+
+bool MediaSessionConfigImpl::frame_assembly_enabled() const {
+  return frame_assembly_enabled_;
+}
+
+RtpVideoCodec MediaSessionConfigImpl::video_codec() const {
+  return video_codec_;
+}
+
+uint32_t MediaSessionConfigImpl::catch_up_threshold_ms() const {
+  return catch_up_threshold_ms_;
+}
+
+MediaType MediaSessionConfigImpl::media_type_local() const {
+  return media_type_local_;
+}
+
+int MediaSessionConfigImpl::fec_payload_type_local() const {
+  return fec_payload_type_local_;
+}
+
+bool MediaSessionConfigImpl::auto_sequencing_enabled() const {
+  return auto_sequencing_enabled_;
+}
+
 MediaTransmissionDirection MediaSessionConfigImpl::direction() const {
   return direction_;
 }
@@ -269,7 +400,12 @@ MediaSessionCallback* MediaSessionConfigImpl::callback() const {
 }
 
 QosrtpSessionConfigImpl::QosrtpSessionConfigImpl()
-    : address_local_(nullptr), address_remote_(nullptr), cname_("") {}
+    : address_local_(nullptr),
+      address_remote_(nullptr),
+      cname_(""),
+      pacing_rate_bps_(0),
+      pacing_burst_bytes_(0),
+      kernel_pacing_enabled_(false) {}
 
 QosrtpSessionConfigImpl::~QosrtpSessionConfigImpl() = default;
 
@@ -297,6 +433,16 @@ void QosrtpSessionConfigImpl::ClearMediaSessionConfig() {
   map_media_session_config_.clear();
 }
 
+void QosrtpSessionConfigImpl::SetPacing(uint32_t rate_bps,
+                                        uint32_t burst_bytes) {
+  pacing_rate_bps_ = rate_bps;
+  pacing_burst_bytes_ = burst_bytes;
+}
+
+void QosrtpSessionConfigImpl::EnableKernelPacing(bool enabled) {
+  kernel_pacing_enabled_ = enabled;
+}
+
 const std::map<std::string, std::unique_ptr<MediaSessionConfig>>&
 QosrtpSessionConfigImpl::map_media_session_config() const {
   return map_media_session_config_;
@@ -312,6 +458,18 @@ TransportAddress* QosrtpSessionConfigImpl::address_remote() const {
 
 const std::string& QosrtpSessionConfigImpl::cname() const { return cname_; }
 
+uint32_t QosrtpSessionConfigImpl::pacing_rate_bps() const {
+  return pacing_rate_bps_;
+}
+
+uint32_t QosrtpSessionConfigImpl::pacing_burst_bytes() const {
+  return pacing_burst_bytes_;
+}
+
+bool QosrtpSessionConfigImpl::kernel_pacing_enabled() const {
+  return kernel_pacing_enabled_;
+}
+
 QosrtpSessionImpl::QosrtpSessionImpl()
     : config_(nullptr),
       signaling_thread_(nullptr),
@@ -362,6 +520,9 @@ std::unique_ptr<Result> QosrtpSessionImpl::StartSession(
     result_description << "Failed to create rtcp rtp tranceiver";
     goto failed;
   }
+  rtp_rtcp_tranceiver_->SetPacing(config_->pacing_rate_bps(),
+                                  config_->pacing_burst_bytes(),
+                                  config_->kernel_pacing_enabled());
   for (auto iter_media_session_config = media_session_configs.begin();
        iter_media_session_config != media_session_configs.end();
        ++iter_media_session_config) {
@@ -405,4 +566,63 @@ void QosrtpSessionImpl::SendRtpPacket(std::unique_ptr<RtpPacket> pkt) {
     }
   }
 }
+
+void QosrtpSessionImpl::SendRtpPackets(
+    std::vector<std::unique_ptr<RtpPacket>> packets,
+    uint64_t capture_time_utc_ms, const FrameSendOptions& options) {
+  if (!has_started_.load())
+    return;
+  if (packets.empty() || (nullptr == packets.front())) return;
+  for (auto iter_media_session = media_sessions_.begin();
+       iter_media_session != media_sessions_.end(); ++iter_media_session) {
+    if ((*iter_media_session)->GetLocalSsrc() == packets.front()->ssrc()) {
+      (*iter_media_session)
+          ->SendRtpPackets(std::move(packets), capture_time_utc_ms, options);
+      break;
+    }
+  }
+}
+
+std::unique_ptr<Result> QosrtpSessionImpl::SendFrame(
+    uint32_t ssrc, std::unique_ptr<DataBuffer> frame, uint8_t payload_type,
+    RtpPacketization packetization, uint16_t mtu,
+    uint64_t capture_time_utc_ms, const FrameSendOptions& options) {
+  if (!has_started_.load())
+    return Result::Create(-1, "The session has not started");
+  for (auto iter_media_session = media_sessions_.begin();
+       iter_media_session != media_sessions_.end(); ++iter_media_session) {
+    if ((*iter_media_session)->GetLocalSsrc() == ssrc) {
+      return (*iter_media_session)
+          ->SendFrame(std::move(frame), payload_type, packetization, mtu,
+                      capture_time_utc_ms, options);
+    }
+  }
+  return Result::Create(-1, "No media session sends with the ssrc");
+}
+
+std::unique_ptr<Result> QosrtpSessionImpl::GetReceiveStatistics(
+    uint32_t ssrc, MediaReceiveStatistics& statistics) {
+  if (!has_started_.load())
+    return Result::Create(-1, "The session has not started");
+  for (auto iter_media_session = media_sessions_.begin();
+       iter_media_session != media_sessions_.end(); ++iter_media_session) {
+    if ((*iter_media_session)->GetLocalSsrc() == ssrc) {
+      return (*iter_media_session)->GetReceiveStatistics(statistics);
+    }
+  }
+  return Result::Create(-1, "No media session has the ssrc");
+}
+
+std::unique_ptr<Result> QosrtpSessionImpl::GetSendStatistics(
+    uint32_t ssrc, MediaSendStatistics& statistics) {
+  if (!has_started_.load())
+    return Result::Create(-1, "The session has not started");
+  for (auto iter_media_session = media_sessions_.begin();
+       iter_media_session != media_sessions_.end(); ++iter_media_session) {
+    if ((*iter_media_session)->GetLocalSsrc() == ssrc) {
+      return (*iter_media_session)->GetSendStatistics(statistics);
+    }
+  }
+  return Result::Create(-1, "No media session has the ssrc");
+}
 }  // namespace qosrtp
\ No newline at end of file
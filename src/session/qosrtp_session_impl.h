@@ -69,6 +69,9 @@ class RtxConfigImpl : public RtxConfig {
       uint8_t rtx_pt, uint8_t associated_pt) override;
   virtual void DeleteRtxAndAssociatedPayloadType(uint8_t rtx_pt) override;
   virtual void ClearRtxPayload() override;
+  virtual void SetHistoryBounds(uint16_t min_duration_ms,
+                                uint32_t max_bytes) override;
+  virtual void SetMaxBitrateRatio(uint16_t max_percent) override;
   /**
    * call
    * SetRtxAndAssociatedPayloadType\DeleteRtxAndAssociatedPayloadType\ClearRtxPayload
@@ -76,10 +79,16 @@ class RtxConfigImpl : public RtxConfig {
    */
   virtual const std::map<uint8_t, uint8_t>& map_rtx_payload_type() const override;
   virtual uint16_t max_cache_seq_difference() const override;
+  virtual uint16_t history_min_duration_ms() const override;
+  virtual uint32_t history_max_bytes() const override;
+  virtual uint16_t max_bitrate_percent() const override;
   virtual uint32_t ssrc() const override;
 
  private:
   uint16_t max_cache_seq_difference_;
+  uint16_t history_min_duration_ms_;
+  uint32_t history_max_bytes_;
+  uint16_t max_bitrate_percent_;
   uint32_t ssrc_;
   std::map<uint8_t, uint8_t> map_rtx_payload_type_;
 };
@@ -98,6 +107,17 @@ class MediaSessionConfigImpl : public MediaSessionConfig {
       const uint16_t* max_cache_duration_ms,
       MediaTransmissionDirection direction, int rtcp_report_interval_ms,
       MediaSessionCallback* callback) override;
+  virtual void SetExpectedReceiveBitrate(uint32_t bitrate_bps) override;
+  virtual void SetReceiveCacheByteBudget(uint32_t max_bytes) override;
+  virtual std::unique_ptr<Result> SetJitterBufferDelayBounds(
+      uint16_t min_delay_ms, uint16_t max_delay_ms) override;
+  virtual void EnableFrameAssembly(bool enabled) override;
+  virtual void SetVideoCodec(RtpVideoCodec codec) override;
+  virtual void SetCatchUpThreshold(uint32_t threshold_ms) override;
+  virtual void SetLocalMediaType(MediaType type) override;
+  virtual std::unique_ptr<Result> SetLocalFecPayloadType(
+      uint8_t fec_pt) override;
+  virtual void EnableAutoSequencing(bool enabled) override;
 
   virtual uint32_t ssrc_media_local() const override;
   virtual const RtxConfig* rtx_config_local() const override;
@@ -108,6 +128,16 @@ class MediaSessionConfigImpl : public MediaSessionConfig {
   virtual uint32_t rtp_clock_rate_hz_remote() const override;
   virtual const std::vector<uint8_t>& rtp_payload_types_remote() const override;
   virtual uint16_t max_cache_duration_ms() const override;
+  virtual uint32_t expected_receive_bitrate_bps() const override;
+  virtual uint32_t receive_cache_max_bytes() const override;
+  virtual uint16_t jitter_buffer_min_delay_ms() const override;
+  virtual uint16_t jitter_buffer_max_delay_ms() const override;
+  virtual bool frame_assembly_enabled() const override;
+  virtual RtpVideoCodec video_codec() const override;
+  virtual uint32_t catch_up_threshold_ms() const override;
+  virtual MediaType media_type_local() const override;
+  virtual int fec_payload_type_local() const override;
+  virtual bool auto_sequencing_enabled() const override;
   virtual MediaTransmissionDirection direction() const override;
   virtual int rtcp_report_interval_ms() const override;
   virtual MediaSessionCallback* callback() const override;
@@ -138,6 +168,16 @@ class MediaSessionConfigImpl : public MediaSessionConfig {
   std::vector<uint8_t> rtp_payload_types_remote_;
   MediaSessionCallback* callback_;
   uint16_t max_cache_duration_ms_;
+  uint32_t expected_receive_bitrate_bps_;
+  uint32_t receive_cache_max_bytes_;
+  uint16_t jitter_buffer_min_delay_ms_;
+  uint16_t jitter_buffer_max_delay_ms_;
+  bool frame_assembly_enabled_;
+  RtpVideoCodec video_codec_;
+  uint32_t catch_up_threshold_ms_;
+  MediaType media_type_local_;
+  int fec_payload_type_local_;
+  bool auto_sequencing_enabled_;
 };
 
 class QosrtpSessionConfigImpl : public QosrtpSessionConfig {
@@ -157,10 +197,15 @@ class QosrtpSessionConfigImpl : public QosrtpSessionConfig {
       std::unique_ptr<MediaSessionConfig> config) override;
   virtual void DeleteMediaSessionConfig(std::string name) override;
   virtual void ClearMediaSessionConfig() override;
+  virtual void SetPacing(uint32_t rate_bps, uint32_t burst_bytes) override;
+  virtual void EnableKernelPacing(bool enabled) override;
 
   virtual TransportAddress* address_local() const override;
   virtual TransportAddress* address_remote() const override;
   virtual const std::string& cname() const override;
+  virtual uint32_t pacing_rate_bps() const override;
+  virtual uint32_t pacing_burst_bytes() const override;
+  virtual bool kernel_pacing_enabled() const override;
   /* call AddMediaSessionConfig and DeleteMediaSessionConfig
    * may change this return map*/
   virtual const std::map<std::string, std::unique_ptr<MediaSessionConfig>>&
@@ -172,6 +217,9 @@ class QosrtpSessionConfigImpl : public QosrtpSessionConfig {
   std::map<std::string, std::unique_ptr<MediaSessionConfig>>
       map_media_session_config_;
   std::string cname_;
+  uint32_t pacing_rate_bps_;
+  uint32_t pacing_burst_bytes_;
+  bool kernel_pacing_enabled_;
 };
 
 class QosrtpSessionImpl : public QosrtpSession {
@@ -181,6 +229,17 @@ class QosrtpSessionImpl : public QosrtpSession {
   virtual std::unique_ptr<Result> StartSession(
       std::unique_ptr<QosrtpSessionConfig> config) override;
   virtual void SendRtpPacket(std::unique_ptr<RtpPacket> pkt) override;
+  virtual void SendRtpPackets(std::vector<std::unique_ptr<RtpPacket>> packets,
+                              uint64_t capture_time_utc_ms,
+                              const FrameSendOptions& options) override;
+  virtual std::unique_ptr<Result> SendFrame(
+      uint32_t ssrc, std::unique_ptr<DataBuffer> frame, uint8_t payload_type,
+      RtpPacketization packetization, uint16_t mtu,
+      uint64_t capture_time_utc_ms, const FrameSendOptions& options) override;
+  virtual std::unique_ptr<Result> GetReceiveStatistics(
+      uint32_t ssrc, MediaReceiveStatistics& statistics) override;
+  virtual std::unique_ptr<Result> GetSendStatistics(
+      uint32_t ssrc, MediaSendStatistics& statistics) override;
 
  private:
   std::unique_ptr<QosrtpSessionConfig> config_;
@@ -0,0 +1,53 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace qosrtp {
+Arena::Arena() : Arena(kDefaultBlockSize) {}
+
+Arena::Arena(size_t block_size)
+    : block_size_(block_size), current_block_(0), offset_(0) {}
+
+Arena::~Arena() { Reset(); }
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+  while (current_block_ < blocks_.size()) {
+    Block& block = blocks_[current_block_];
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+    size_t aligned_offset =
+        ((base + offset_ + alignment - 1) & ~(alignment - 1)) - base;
+    if (aligned_offset + size <= block.size) {
+      offset_ = aligned_offset + size;
+      return block.memory.get() + aligned_offset;
+    }
+    ++current_block_;
+    offset_ = 0;
+  }
+  Block block;
+  block.size = std::max(block_size_, size + alignment);
+  block.memory = std::make_unique<uint8_t[]>(block.size);
+  blocks_.push_back(std::move(block));
+  current_block_ = blocks_.size() - 1;
+  offset_ = 0;
+  return Allocate(size, alignment);
+}
+
+void Arena::Reset() {
+  for (auto iter = destructors_.rbegin(); iter != destructors_.rend();
+       ++iter) {
+    iter->destroy(iter->object);
+  }
+  destructors_.clear();
+  current_block_ = 0;
+  offset_ = 0;
+}
+
+size_t Arena::allocated_bytes() const {
+  size_t bytes = 0;
+  for (auto& block : blocks_) {
+    bytes += block.size;
+  }
+  return bytes;
+}
+}  // namespace qosrtp
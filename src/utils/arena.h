@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace qosrtp {
+// Bump allocator for objects whose lifetime ends together, e.g. everything
+// parsed out of one receive batch. Objects are carved from large blocks and
+// destroyed in one Reset(). The blocks are kept across Reset(), so a batch
+// that fits in what previous batches used does not touch the heap.
+// Not thread safe, an arena belongs to the thread that handles the batch.
+class Arena {
+ public:
+  static constexpr size_t kDefaultBlockSize = 4096;
+  Arena();
+  explicit Arena(size_t block_size);
+  ~Arena();
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* Allocate(size_t size, size_t alignment);
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    void* memory = Allocate(sizeof(T), alignof(T));
+    T* object = new (memory) T(std::forward<Args>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      destructors_.push_back(
+          {object, [](void* p) { static_cast<T*>(p)->~T(); }});
+    }
+    return object;
+  }
+  // Destroys the objects in reverse order of creation and rewinds the arena.
+  void Reset();
+  size_t allocated_bytes() const;
+
+ private:
+  struct Block {
+    std::unique_ptr<uint8_t[]> memory;
+    size_t size;
+  };
+  struct Destructor {
+    void* object;
+    void (*destroy)(void*);
+  };
+  const size_t block_size_;
+  std::vector<Block> blocks_;
+  size_t current_block_;
+  size_t offset_;
+  std::vector<Destructor> destructors_;
+};
+}  // namespace qosrtp
@@ -1,5 +1,7 @@
 #include "./data_buffer_impl.h"
 
+#include <cstring>
+
 namespace qosrtp {
 DataBufferImpl::~DataBufferImpl() {}
 
@@ -16,11 +18,6 @@ uint32_t DataBufferImpl::CutTail(uint32_t size_cut) {
   return size_cut_real;
 }
 
-uint32_t DataBufferImpl::SetSize(uint32_t size) {
-  size_ = size > capacity_ ? capacity_ : size;
-  return size_;
-}
-
 // Only allow to modify the position smaller than size
 bool DataBufferImpl::ModifyAt(uint32_t pos, const uint8_t* data,
                               uint32_t size_modified) {
@@ -38,20 +35,4 @@ bool DataBufferImpl::MemSet(uint32_t pos, uint8_t value, uint32_t size_set) {
   std::memset(buffer_.get() + pos, value, size_set);
   return true;
 }
-
-// Only allow to get pointer whose position smaller than size
-const uint8_t* DataBufferImpl::At(uint32_t pos) const {
-  if (pos > size_) {
-    return nullptr;
-  }
-  return buffer_.get() + pos;
-}
-
-const uint8_t* DataBufferImpl::Get() const { return buffer_.get(); }
-
-uint8_t* DataBufferImpl::GetW() { return buffer_.get(); }
-
-uint32_t DataBufferImpl::size() const { return size_; }
-
-uint32_t DataBufferImpl::capacity() const { return capacity_; }
 }  // namespace qosrtp
\ No newline at end of file
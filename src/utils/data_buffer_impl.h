@@ -4,7 +4,9 @@
 #include "../include/data_buffer.h"
 
 namespace qosrtp {
-class DataBufferImpl : public DataBuffer {
+// final so that calls made through a DataBufferImpl pointer inside the library
+// are resolved statically, the trivial accessors are inlined as well.
+class DataBufferImpl final : public DataBuffer {
  public:
   DataBufferImpl() = delete;
   DataBufferImpl(uint32_t capacity)
@@ -15,21 +17,29 @@ class DataBufferImpl : public DataBuffer {
   virtual ~DataBufferImpl() override;
   virtual uint32_t Append(uint32_t size_appended) override;
   virtual uint32_t CutTail(uint32_t size_cut) override;
-  virtual uint32_t SetSize(uint32_t size) override;
+  virtual uint32_t SetSize(uint32_t size) override {
+    size_ = size > capacity_ ? capacity_ : size;
+    return size_;
+  }
   // Only allow to modify the position smaller than size
   virtual bool ModifyAt(uint32_t pos, const uint8_t* data,
                         uint32_t size_modified) override;
   virtual bool MemSet(uint32_t pos, uint8_t value, uint32_t size_set) override;
   // Only allow to get pointer whose position smaller than size
-  virtual const uint8_t* At(uint32_t pos) const override;
-  virtual const uint8_t* Get() const override;
-  virtual uint8_t* GetW() override;
-  virtual uint32_t size() const override;
-  virtual uint32_t capacity() const override;
+  virtual const uint8_t* At(uint32_t pos) const override {
+    if (pos > size_) {
+      return nullptr;
+    }
+    return buffer_.get() + pos;
+  }
+  virtual const uint8_t* Get() const override { return buffer_.get(); }
+  virtual uint8_t* GetW() override { return buffer_.get(); }
+  virtual uint32_t size() const override { return size_; }
+  virtual uint32_t capacity() const override { return capacity_; }
 
  private:
   uint32_t size_;
   uint32_t capacity_;
-  std::unique_ptr<uint8_t> buffer_;
+  std::unique_ptr<uint8_t[]> buffer_;
 };
-}  // namespace qosrtp
\ No newline at end of file
+}  // namespace qosrtp
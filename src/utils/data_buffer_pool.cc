@@ -0,0 +1,59 @@
+#include "data_buffer_pool.h"
+
+#include <algorithm>
+
+namespace qosrtp {
+DataBufferPool::DataBufferPool(uint32_t nb_buffers,
+                               uint32_t initial_capacity) {
+  nb_buffers = std::min<uint32_t>(nb_buffers, kMaxNbBuffers);
+  for (uint32_t i = 0; i < nb_buffers; ++i) {
+    buffers_.push_back(DataBuffer::Create(initial_capacity));
+  }
+}
+
+DataBufferPool::~DataBufferPool() = default;
+
+std::unique_ptr<DataBuffer> DataBufferPool::Acquire(uint32_t capacity) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter_best = buffers_.end();
+    for (auto iter = buffers_.begin(); iter != buffers_.end(); ++iter) {
+      if ((*iter)->capacity() < capacity) continue;
+      if ((iter_best == buffers_.end()) ||
+          ((*iter)->capacity() < (*iter_best)->capacity())) {
+        iter_best = iter;
+      }
+    }
+    if (iter_best != buffers_.end()) {
+      std::unique_ptr<DataBuffer> buffer = std::move(*iter_best);
+      buffers_.erase(iter_best);
+      buffer->SetSize(0);
+      return buffer;
+    }
+  }
+  uint32_t headroom = capacity / 4;
+  uint32_t new_capacity =
+      (capacity + headroom + kCapacityGranularity - 1) /
+      kCapacityGranularity * kCapacityGranularity;
+  return DataBuffer::Create(std::max(new_capacity, capacity));
+}
+
+void DataBufferPool::Release(std::unique_ptr<DataBuffer> buffer) {
+  if (nullptr == buffer) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (buffers_.size() < kMaxNbBuffers) {
+    buffers_.push_back(std::move(buffer));
+    return;
+  }
+  // Full, keep the larger buffers since they fit every frame.
+  auto iter_smallest = std::min_element(
+      buffers_.begin(), buffers_.end(),
+      [](const std::unique_ptr<DataBuffer>& a,
+         const std::unique_ptr<DataBuffer>& b) {
+        return a->capacity() < b->capacity();
+      });
+  if ((*iter_smallest)->capacity() < buffer->capacity()) {
+    *iter_smallest = std::move(buffer);
+  }
+}
+}  // namespace qosrtp
\ No newline at end of file
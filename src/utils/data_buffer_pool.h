@@ -0,0 +1,30 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../include/data_buffer.h"
+
+namespace qosrtp {
+// Recycles DataBuffers that hold data of similar size, e.g. the bitstream of
+// successive frames, so that steady state does not touch the heap. Thread
+// safe, a buffer may be released on another thread than it was acquired on.
+class DataBufferPool {
+ public:
+  DataBufferPool(uint32_t nb_buffers, uint32_t initial_capacity);
+  ~DataBufferPool();
+  DataBufferPool(const DataBufferPool&) = delete;
+  DataBufferPool& operator=(const DataBufferPool&) = delete;
+  // Returns an empty buffer whose capacity is at least capacity.
+  std::unique_ptr<DataBuffer> Acquire(uint32_t capacity);
+  void Release(std::unique_ptr<DataBuffer> buffer);
+
+ private:
+  static constexpr size_t kMaxNbBuffers = 8;
+  // New buffers get some headroom so that a slightly larger frame does not
+  // need another one.
+  static constexpr uint32_t kCapacityGranularity = 4096;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<DataBuffer>> buffers_;
+};
+}  // namespace qosrtp
\ No newline at end of file
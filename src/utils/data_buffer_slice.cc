@@ -0,0 +1,72 @@
+#include "./data_buffer_slice.h"
+
+#include <cstring>
+
+namespace qosrtp {
+DataBufferSlice::DataBufferSlice(std::shared_ptr<const DataBuffer> buffer,
+                                 uint32_t offset, uint32_t size)
+    : DataBuffer(),
+      buffer_(std::move(buffer)),
+      own_buffer_(nullptr),
+      data_(nullptr) {
+  if ((nullptr == buffer_) || (offset > buffer_->size())) {
+    size = 0;
+  } else {
+    data_ = buffer_->Get() + offset;
+    if (size > buffer_->size() - offset) size = buffer_->size() - offset;
+  }
+  size_ = size;
+  capacity_ = size;
+}
+
+DataBufferSlice::~DataBufferSlice() {}
+
+uint32_t DataBufferSlice::Append(uint32_t size_appended) {
+  uint32_t size_appended_real =
+      (size_ + size_appended) > capacity_ ? (capacity_ - size_) : size_appended;
+  size_ += size_appended_real;
+  return size_appended_real;
+}
+
+uint32_t DataBufferSlice::CutTail(uint32_t size_cut) {
+  uint32_t size_cut_real = (size_cut > size_) ? size_ : size_cut;
+  size_ -= size_cut_real;
+  return size_cut_real;
+}
+
+bool DataBufferSlice::ModifyAt(uint32_t pos, const uint8_t* data,
+                               uint32_t size_modified) {
+  if ((pos > size_) || ((pos + size_modified) > size_)) {
+    return false;
+  }
+  uint8_t* data_w = Detach();
+  if (nullptr == data_w) return false;
+  std::memcpy(data_w + pos, data, size_modified);
+  return true;
+}
+
+bool DataBufferSlice::MemSet(uint32_t pos, uint8_t value, uint32_t size_set) {
+  if ((pos > size_) || ((pos + size_set) > size_)) {
+    return false;
+  }
+  uint8_t* data_w = Detach();
+  if (nullptr == data_w) return false;
+  std::memset(data_w + pos, value, size_set);
+  return true;
+}
+
+uint8_t* DataBufferSlice::GetW() { return Detach(); }
+
+uint8_t* DataBufferSlice::Detach() {
+  if (nullptr == own_buffer_) {
+    if (0 == capacity_) return nullptr;
+    own_buffer_ = DataBuffer::Create(capacity_);
+    own_buffer_->SetSize(capacity_);
+    std::memcpy(own_buffer_->GetW(), data_, capacity_);
+    data_ = own_buffer_->Get();
+    // The frame may be released as soon as no slice views it.
+    buffer_ = nullptr;
+  }
+  return own_buffer_->GetW();
+}
+}  // namespace qosrtp
\ No newline at end of file
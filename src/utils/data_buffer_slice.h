@@ -0,0 +1,46 @@
+#pragma once
+#include <memory>
+
+#include "../include/data_buffer.h"
+
+namespace qosrtp {
+// A view of size bytes of buffer from offset on, sharing the ownership of
+// buffer, so that the payloads cut out of one frame need no copies. It can
+// shrink but not grow. The first write copies the viewed bytes into a buffer
+// of its own, buffer is never written.
+class DataBufferSlice final : public DataBuffer {
+ public:
+  DataBufferSlice() = delete;
+  DataBufferSlice(std::shared_ptr<const DataBuffer> buffer, uint32_t offset,
+                  uint32_t size);
+  virtual ~DataBufferSlice() override;
+  virtual uint32_t Append(uint32_t size_appended) override;
+  virtual uint32_t CutTail(uint32_t size_cut) override;
+  virtual uint32_t SetSize(uint32_t size) override {
+    size_ = size > capacity_ ? capacity_ : size;
+    return size_;
+  }
+  virtual bool ModifyAt(uint32_t pos, const uint8_t* data,
+                        uint32_t size_modified) override;
+  virtual bool MemSet(uint32_t pos, uint8_t value, uint32_t size_set) override;
+  virtual const uint8_t* At(uint32_t pos) const override {
+    if (pos > size_) {
+      return nullptr;
+    }
+    return data_ + pos;
+  }
+  virtual const uint8_t* Get() const override { return data_; }
+  virtual uint8_t* GetW() override;
+  virtual uint32_t size() const override { return size_; }
+  virtual uint32_t capacity() const override { return capacity_; }
+
+ private:
+  // Copies the viewed bytes into own_buffer_ unless done already.
+  uint8_t* Detach();
+  std::shared_ptr<const DataBuffer> buffer_;
+  std::unique_ptr<DataBuffer> own_buffer_;
+  const uint8_t* data_;
+  uint32_t size_;
+  uint32_t capacity_;
+};
+}  // namespace qosrtp
\ No newline at end of file
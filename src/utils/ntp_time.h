@@ -86,4 +86,18 @@ inline int64_t UQ32x32ToInt64Ms(uint64_t q32x32) {
   return static_cast<int64_t>(
       std::round(q32x32 * (1000.0 / NtpTime::kFractionsPerSecond)));
 }
+
+// The middle 32 bits of the NTP timestamp, the format of LSR and LRR.
+inline uint32_t CompactNtp(NtpTime ntp) {
+  return static_cast<uint32_t>(static_cast<uint64_t>(ntp) >> 16);
+}
+
+// Converts a compact NTP interval (1/65536 seconds) to milliseconds. An
+// interval that went negative because of clock drift is reported as 1 ms.
+inline int64_t CompactNtpIntervalToMs(uint32_t compact_ntp_interval) {
+  if (compact_ntp_interval > 0x80000000) return 1;
+  int64_t ms =
+      (static_cast<int64_t>(compact_ntp_interval) * 1000 + (1 << 15)) >> 16;
+  return (ms > 0) ? ms : 1;
+}
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <limits>
 #include <memory>
 
@@ -44,4 +45,48 @@ inline uint16_t DiffSeq(uint16_t a, uint16_t b) {
   }
   return b + std::numeric_limits<uint16_t>::max() - a + 1;
 }
+
+// Maps 16-bit sequence numbers onto a 64-bit space that does not wrap.
+// Each seq is unwrapped to the value closest to the previous one, so the
+// result is only correct while consecutive seqs are less than half the
+// sequence space apart. The first seq is returned unchanged.
+class SeqUnwrapper {
+ public:
+  int64_t Unwrap(uint16_t seq) {
+    if (has_last_unwrapped_seq_) {
+      uint16_t last_seq = static_cast<uint16_t>(last_unwrapped_seq_);
+      last_unwrapped_seq_ +=
+          static_cast<int16_t>(static_cast<uint16_t>(seq - last_seq));
+    } else {
+      last_unwrapped_seq_ = seq;
+      has_last_unwrapped_seq_ = true;
+    }
+    return last_unwrapped_seq_;
+  }
+
+ private:
+  int64_t last_unwrapped_seq_ = 0;
+  bool has_last_unwrapped_seq_ = false;
+};
+
+// Same as SeqUnwrapper for 32-bit rtp timestamps.
+class TimestampUnwrapper {
+ public:
+  int64_t Unwrap(uint32_t timestamp) {
+    if (has_last_unwrapped_timestamp_) {
+      uint32_t last_timestamp =
+          static_cast<uint32_t>(last_unwrapped_timestamp_);
+      last_unwrapped_timestamp_ += static_cast<int32_t>(
+          static_cast<uint32_t>(timestamp - last_timestamp));
+    } else {
+      last_unwrapped_timestamp_ = timestamp;
+      has_last_unwrapped_timestamp_ = true;
+    }
+    return last_unwrapped_timestamp_;
+  }
+
+ private:
+  int64_t last_unwrapped_timestamp_ = 0;
+  bool has_last_unwrapped_timestamp_ = false;
+};
 }  // namespace qosrtp
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace qosrtp {
+// Publishes a value from one writer thread to any number of reader threads
+// without a lock. The writer never waits, a reader retries while a write is
+// in progress. The value is kept in atomic words, so a torn read is thrown
+// away rather than being a data race.
+template <class T>
+class SeqLock {
+ public:
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SeqLock needs a trivially copyable type");
+  SeqLock() : sequence_(0) { Store(T()); }
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  // Only one thread may call it.
+  void Store(const T& value) {
+    uint64_t words[kNbWords] = {};
+    memcpy(words, &value, sizeof(T));
+    uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kNbWords; ++i) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  T Load() const {
+    uint64_t words[kNbWords];
+    uint32_t sequence_begin = 0;
+    uint32_t sequence_end = 0;
+    do {
+      sequence_begin = sequence_.load(std::memory_order_acquire);
+      for (size_t i = 0; i < kNbWords; ++i) {
+        words[i] = words_[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      sequence_end = sequence_.load(std::memory_order_relaxed);
+    } while ((sequence_begin & 1) || (sequence_begin != sequence_end));
+    T value;
+    memcpy(&value, words, sizeof(T));
+    return value;
+  }
+
+ private:
+  static constexpr size_t kNbWords = (sizeof(T) + 7) / 8;
+  // Odd while a write is in progress.
+  std::atomic<uint32_t> sequence_;
+  std::atomic<uint64_t> words_[kNbWords];
+};
+}  // namespace qosrtp
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include "../include/result.h"
+
+namespace qosrtp {
+// Value type status used by the internal packet paths instead of
+// std::unique_ptr<Result>, so that the success case costs no allocation.
+// The description must point to a string with static storage duration.
+class Status {
+ public:
+  static constexpr Status Ok() { return Status(); }
+  static constexpr Status Error(const char* description) {
+    return Status(-1, description);
+  }
+  constexpr Status() : code_(Result::kSuccessCode), description_("") {}
+  constexpr Status(int32_t code, const char* description)
+      : code_(code), description_(description) {}
+  int32_t code() const { return code_; }
+  const char* description() const { return description_; }
+  bool ok() const { return code_ == Result::kSuccessCode; }
+  // Adapter for the exported interfaces, which still report unique_ptr<Result>.
+  std::unique_ptr<Result> ToResult() const {
+    if (ok()) {
+      return Result::Create();
+    }
+    return Result::Create(code_, description_);
+  }
+
+ private:
+  int32_t code_;
+  const char* description_;
+};
+}  // namespace qosrtp
@@ -32,6 +32,7 @@ Thread::DelayedTask::~DelayedTask() = default;
 Thread::Thread(std::string thread_name, ThreadWaitTask* wait_task)
     : thread_name_(thread_name), thread_() {
   wait_task_ = wait_task;
+  has_pending_task_ = false;
   runing_.store(false);
   should_stop_.store(false);
 }
@@ -60,7 +61,11 @@ void Thread::Stop() {
       return;
     }
   }
-  should_stop_.store(true);
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    should_stop_.store(true);
+    condition_.notify_all();
+  }
   if (wait_task_) wait_task_->WaitUp();
   if (thread_.joinable()) {
     thread_.join();
@@ -82,6 +87,8 @@ void Thread::PushTask(std::unique_ptr<CallableWrapper> f) {
     return;
   }
   task_queue_.push(std::move(f));
+  has_pending_task_ = true;
+  condition_.notify_one();
   if (wait_task_) wait_task_->WaitUp();
 }
 
@@ -94,6 +101,8 @@ void Thread::PushTask(std::unique_ptr<CallableWrapper> f,
   std::unique_ptr<DelayedTask> delayed_task =
       std::make_unique<DelayedTask>(std::move(f), wait_duration_ms);
   delayed_task_list_.push_back(std::move(delayed_task));
+  has_pending_task_ = true;
+  condition_.notify_one();
   if (wait_task_) wait_task_->WaitUp();
 }
 
@@ -127,8 +136,6 @@ void Thread::ThreadMain() {
         for (auto iter_delayed_task = delayed_task_list_.begin();
              iter_delayed_task != delayed_task_list_.end();
              iter_delayed_task++) {
-          if ((*iter_delayed_task)->execution_time_utc_ms < wait_duration_ms)
-            wait_duration_ms = (*iter_delayed_task)->execution_time_utc_ms;
           if ((*iter_delayed_task)->execution_time_utc_ms <= utc_ms_now) {
             delayed_task = std::move(*iter_delayed_task);
             delayed_task_list_.erase(iter_delayed_task);
@@ -140,7 +147,16 @@ void Thread::ThreadMain() {
           task_f = std::move(task_queue_.front());
           task_queue_.pop();
         }
-        if ((!task_f) && (!delayed_task)) break;
+        if ((!task_f) && (!delayed_task)) {
+          // Sleep until the earliest delayed task is due, not until an
+          // absolute timestamp.
+          for (auto& pending_task : delayed_task_list_) {
+            uint64_t duration_ms =
+                pending_task->execution_time_utc_ms - utc_ms_now;
+            if (duration_ms < wait_duration_ms) wait_duration_ms = duration_ms;
+          }
+          break;
+        }
       }
       if (task_f)
         (*task_f)();
@@ -148,7 +164,21 @@ void Thread::ThreadMain() {
         (*(delayed_task->f))();
     } while (!should_stop_.load());
     if (should_stop_.load()) break;
-    if (wait_task_) wait_task_->Wait(wait_duration_ms);
+    if (wait_task_) {
+      wait_task_->Wait(wait_duration_ms);
+    } else {
+      std::unique_lock<std::mutex> lock(mutex_);
+      auto wake_up = [this] {
+        return should_stop_.load() || has_pending_task_;
+      };
+      if (ThreadWaitTask::kForever == wait_duration_ms) {
+        condition_.wait(lock, wake_up);
+      } else {
+        condition_.wait_for(lock, std::chrono::milliseconds(wait_duration_ms),
+                            wake_up);
+      }
+      has_pending_task_ = false;
+    }
   }
   QOSRTP_LOG(Info, "Thread end: %s", thread_name_.c_str());
 }
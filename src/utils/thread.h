@@ -112,6 +112,9 @@ class Thread {
     std::unique_ptr<CallableWrapper> f;
   };
   std::list<std::unique_ptr<DelayedTask>> delayed_task_list_;
+  // Used to sleep between tasks when no ThreadWaitTask is provided.
+  std::condition_variable condition_;
+  bool has_pending_task_;
   std::atomic<bool> should_stop_;
   std::atomic<bool> runing_;
   ThreadWaitTask* wait_task_;
@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <memory>
 #if defined(_MSC_VER)
 #include <windows.h>
@@ -45,6 +46,13 @@ inline uint64_t UTCTimeMillis() {
 
 inline uint64_t MilisSince(uint64_t milis) { return UTCTimeMillis() - milis; }
 
+// Monotonic, for measuring intervals only.
+inline uint64_t SteadyTimeMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
 inline uint64_t NtpTimeNow() {
   return (UTCTimeMillis() + kNtpJan1970Millisecs) *
          (kNtpFractionsPerSecond / kNumMillisecsPerSec);
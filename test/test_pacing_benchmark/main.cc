@@ -0,0 +1,233 @@
+#include <Winsock2.h>
+#include <Ws2tcpip.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "qosrtp.h"
+#include "../../src/utils/time_utils.h"
+
+// Sends bursts of packets through a paced QosrtpSession on loopback and
+// measures the spacing of the packets as they arrive on a plain udp socket.
+// Usage: test_pacing_benchmark [rate_bps] [kernel_pacing 0|1]
+static const struct {
+  uint32_t src_ssrc = 789;
+  std::string src_ip = "127.0.0.1";
+  uint16_t src_port = 6666;
+  uint32_t dst_ssrc = 123;
+  std::string dst_ip = "127.0.0.1";
+  uint16_t dst_port = 7777;
+  qosrtp::TransportProtocolType protocol_type =
+      qosrtp::TransportProtocolType::kUdp;
+  uint32_t rtp_clock_rate_hz_local = 90000;
+  std::vector<uint8_t> rtp_payload_types_local = {0};
+  uint32_t rtcp_report_interval_ms = 1000;
+  std::string cname = "test_pacing_benchmark";
+  std::string media_session_name = "test";
+  uint32_t default_rate_bps = 8 * 1000 * 1000;
+  // As many packets as one fec protected frame of test_sender_with_fec.
+  uint32_t nb_packets_per_burst = 48;
+  uint32_t burst_interval_ms = 40;
+  uint16_t payload_size_bytes = 1200;
+  uint32_t duration_ms = 5000;
+} global_config;
+
+class Sender : qosrtp::MediaSessionCallback {
+ public:
+  Sender() = default;
+  virtual void OnRtpPacket(
+      std::vector<std::unique_ptr<qosrtp::RtpPacket>> packets) override {
+    return;
+  }
+  std::unique_ptr<qosrtp::QosrtpSession> ConstructQosrtpSession(
+      uint32_t rate_bps, bool kernel_pacing) {
+    std::unique_ptr<qosrtp::QosrtpSessionConfig> session_config =
+        qosrtp::QosrtpSessionConfig::Create();
+    std::unique_ptr<qosrtp::TransportAddress> src_address =
+        qosrtp::TransportAddress::Create(global_config.src_ip,
+                                         global_config.src_port,
+                                         global_config.protocol_type);
+    std::unique_ptr<qosrtp::TransportAddress> dst_address =
+        qosrtp::TransportAddress::Create(global_config.dst_ip,
+                                         global_config.dst_port,
+                                         global_config.protocol_type);
+    session_config->Configure(std::move(src_address), std::move(dst_address),
+                              global_config.cname);
+    session_config->SetPacing(rate_bps, 0);
+    session_config->EnableKernelPacing(kernel_pacing);
+    std::unique_ptr<qosrtp::MediaSessionConfig> media_session_config =
+        qosrtp::MediaSessionConfig::Create();
+    media_session_config->Configure(
+        global_config.src_ssrc, nullptr, &global_config.rtp_clock_rate_hz_local,
+        &global_config.rtp_payload_types_local, global_config.dst_ssrc, nullptr,
+        nullptr, nullptr, nullptr,
+        qosrtp::MediaTransmissionDirection::kSendOnly,
+        global_config.rtcp_report_interval_ms, this);
+    session_config->AddMediaSessionConfig(global_config.media_session_name,
+                                          std::move(media_session_config));
+    std::unique_ptr<qosrtp::QosrtpSession> qosrtp_session =
+        qosrtp::QosrtpSession::Create();
+    if (!qosrtp_session->StartSession(std::move(session_config))->ok())
+      return nullptr;
+    return qosrtp_session;
+  }
+};
+
+class Receiver {
+ public:
+  Receiver() : stop_signal_(false), sockfd_(INVALID_SOCKET) {}
+  ~Receiver() {
+    stop_signal_.store(true);
+    if (receiver_thread_.joinable()) receiver_thread_.join();
+    if (INVALID_SOCKET != sockfd_) closesocket(sockfd_);
+  }
+  bool Start() {
+    sockfd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (INVALID_SOCKET == sockfd_) return false;
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(global_config.dst_port);
+    inet_pton(AF_INET, global_config.dst_ip.c_str(), &address.sin_addr);
+    if (bind(sockfd_, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) == SOCKET_ERROR) {
+      return false;
+    }
+    DWORD timeout_ms = 100;
+    setsockopt(sockfd_, SOL_SOCKET, SO_RCVTIMEO,
+               reinterpret_cast<const char*>(&timeout_ms), sizeof(timeout_ms));
+    receiver_thread_ = std::thread(&Receiver::ReceiverThreadMain, this);
+    return true;
+  }
+  void Stop() {
+    stop_signal_.store(true);
+    if (receiver_thread_.joinable()) receiver_thread_.join();
+  }
+  const std::vector<uint64_t>& arrival_times_us() const {
+    return arrival_times_us_;
+  }
+
+ private:
+  void ReceiverThreadMain() {
+    char buffer[2048];
+    while (!stop_signal_.load()) {
+      int ret = recv(sockfd_, buffer, sizeof(buffer), 0);
+      if (ret <= 0) continue;
+      // Rtcp packets are not paced.
+      if ((ret >= 2) && (static_cast<uint8_t>(buffer[1]) >= 200) &&
+          (static_cast<uint8_t>(buffer[1]) <= 206)) {
+        continue;
+      }
+      arrival_times_us_.push_back(qosrtp::SteadyTimeMicros());
+    }
+  }
+  std::atomic<bool> stop_signal_;
+  std::thread receiver_thread_;
+  SOCKET sockfd_;
+  std::vector<uint64_t> arrival_times_us_;
+};
+
+static void PrintSpacing(const std::vector<uint64_t>& arrival_times_us,
+                         uint32_t rate_bps) {
+  if (arrival_times_us.size() < 2) {
+    std::cout << "Too few packets received: " << arrival_times_us.size()
+              << std::endl;
+    return;
+  }
+  // Only the gaps inside a burst, the pause between two bursts is not
+  // pacing.
+  uint64_t max_gap_us =
+      static_cast<uint64_t>(global_config.burst_interval_ms) * 1000 / 2;
+  std::vector<uint64_t> gaps_us;
+  for (size_t i = 1; i < arrival_times_us.size(); ++i) {
+    uint64_t gap_us = arrival_times_us[i] - arrival_times_us[i - 1];
+    if (gap_us < max_gap_us) gaps_us.push_back(gap_us);
+  }
+  if (gaps_us.empty()) return;
+  std::sort(gaps_us.begin(), gaps_us.end());
+  uint64_t sum_gap_us = 0;
+  uint32_t nb_back_to_back = 0;
+  for (uint64_t gap_us : gaps_us) {
+    sum_gap_us += gap_us;
+    if (gap_us < 20) ++nb_back_to_back;
+  }
+  // 12 bytes of rtp header on top of the payload.
+  uint64_t expected_gap_us =
+      (static_cast<uint64_t>(global_config.payload_size_bytes) + 12) * 8 *
+      1000000 / rate_bps;
+  std::cout << "packets received: " << arrival_times_us.size() << std::endl;
+  std::cout << "expected gap: " << expected_gap_us << " us" << std::endl;
+  std::cout << "mean gap: " << sum_gap_us / gaps_us.size() << " us"
+            << std::endl;
+  std::cout << "p10 / p50 / p90 / p99 gap: "
+            << gaps_us[gaps_us.size() / 10] << " / "
+            << gaps_us[gaps_us.size() / 2] << " / "
+            << gaps_us[gaps_us.size() * 9 / 10] << " / "
+            << gaps_us[gaps_us.size() * 99 / 100] << " us" << std::endl;
+  std::cout << "back to back (< 20 us): " << nb_back_to_back << " of "
+            << gaps_us.size() << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t rate_bps = global_config.default_rate_bps;
+  bool kernel_pacing = false;
+  if (argc > 1) rate_bps = static_cast<uint32_t>(std::atoi(argv[1]));
+  if (argc > 2) kernel_pacing = (0 != std::atoi(argv[2]));
+  qosrtp::QosrtpInterface::Initialize(nullptr,
+                                      qosrtp::QosrtpLogger::Level::kWarning);
+  Receiver receiver;
+  if (!receiver.Start()) {
+    std::cout << "Failed to start receiver" << std::endl;
+    qosrtp::QosrtpInterface::UnInitialize();
+    return -1;
+  }
+  Sender sender;
+  std::unique_ptr<qosrtp::QosrtpSession> qosrtp_session =
+      sender.ConstructQosrtpSession(rate_bps, kernel_pacing);
+  if (!qosrtp_session) {
+    std::cout << "Failed to construct qosrtp session" << std::endl;
+    qosrtp::QosrtpInterface::UnInitialize();
+    return -1;
+  }
+  std::cout << "rate: " << rate_bps << " bps, kernel pacing: "
+            << (kernel_pacing ? "on" : "off") << std::endl;
+  std::vector<uint32_t> csrcs;
+  uint16_t seq_packet = 0;
+  uint32_t timestamp = 0;
+  uint64_t time_first = qosrtp::UTCTimeMillis();
+  for (uint32_t burst = 0;
+       burst * global_config.burst_interval_ms < global_config.duration_ms;
+       ++burst) {
+    uint64_t burst_time =
+        time_first + burst * global_config.burst_interval_ms;
+    uint64_t time_now = qosrtp::UTCTimeMillis();
+    if (time_now < burst_time) {
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(burst_time - time_now));
+    }
+    for (uint32_t i = 0; i < global_config.nb_packets_per_burst; ++i) {
+      std::unique_ptr<qosrtp::RtpPacket> pkt = qosrtp::RtpPacket::Create();
+      std::unique_ptr<qosrtp::DataBuffer> payload_buffer =
+          qosrtp::DataBuffer::Create(global_config.payload_size_bytes);
+      payload_buffer->SetSize(global_config.payload_size_bytes);
+      payload_buffer->MemSet(0, 0, global_config.payload_size_bytes);
+      pkt->StorePacket(0, seq_packet, timestamp, global_config.src_ssrc, csrcs,
+                       nullptr, std::move(payload_buffer), 0);
+      ++seq_packet;
+      qosrtp_session->SendRtpPacket(std::move(pkt));
+    }
+    timestamp += global_config.rtp_clock_rate_hz_local *
+                 global_config.burst_interval_ms / 1000;
+  }
+  // Lets the last burst drain.
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  qosrtp_session.reset(nullptr);
+  receiver.Stop();
+  PrintSpacing(receiver.arrival_times_us(), rate_bps);
+  qosrtp::QosrtpInterface::UnInitialize();
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "qosrtp.h"
+
+// Times the packet handling that runs through the exported RtpPacket and
+// DataBuffer interfaces inside the library: building packets, serializing
+// and parsing them, and the ulp fec recovery loop. The program only uses
+// the exported api, so the same source measures a library built before and
+// after a change to the concrete types behind it.
+// Usage: test_packet_benchmark [iterations]
+static const struct {
+  uint32_t ssrc = 789;
+  uint8_t payload_type = 96;
+  uint8_t fec_payload_type = 100;
+  std::vector<uint32_t> csrcs = {1, 2};
+  uint16_t payload_size_bytes = 1200;
+  uint32_t default_iterations = 200000;
+  // One key frame worth of packets, every lost packet is recoverable.
+  uint32_t nb_packets_per_frame = 24;
+  // About half as many fec packets as media packets.
+  uint8_t protection_factor = 128;
+  // Every lost_packet_interval-th media packet is lost.
+  uint32_t lost_packet_interval = 8;
+  uint32_t nb_fec_rounds = 200;
+} global_config;
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+static uint64_t ElapsedNs(BenchmarkClock::time_point start) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          BenchmarkClock::now() - start)
+          .count());
+}
+
+static void PrintResult(const char* name, uint64_t elapsed_ns,
+                        uint64_t nb_operations) {
+  std::cout << name << ": " << elapsed_ns / nb_operations << " ns/op over "
+            << nb_operations << " ops" << std::endl;
+}
+
+static std::unique_ptr<qosrtp::RtpPacket> BuildPacket(uint16_t seq,
+                                                      uint32_t timestamp,
+                                                      bool marker) {
+  std::unique_ptr<qosrtp::RtpPacket> pkt = qosrtp::RtpPacket::Create();
+  std::unique_ptr<qosrtp::DataBuffer> payload_buffer =
+      qosrtp::DataBuffer::Create(global_config.payload_size_bytes);
+  payload_buffer->SetSize(global_config.payload_size_bytes);
+  payload_buffer->MemSet(0, static_cast<uint8_t>(seq),
+                         global_config.payload_size_bytes);
+  std::unique_ptr<qosrtp::RtpPacket::Extension> extension =
+      std::make_unique<qosrtp::RtpPacket::Extension>(1);
+  extension->name[0] = 0xbe;
+  extension->name[1] = 0xde;
+  extension->content->MemSet(0, 0, extension->content->size());
+  uint8_t m_payload_type_octet =
+      global_config.payload_type | (marker ? 0x80 : 0x00);
+  pkt->StorePacket(m_payload_type_octet, seq, timestamp, global_config.ssrc,
+                   global_config.csrcs, std::move(extension),
+                   std::move(payload_buffer), 0);
+  return pkt;
+}
+
+// Builds packets, serializes them with LoadPacket and parses the result
+// again, reading the fields back as a receiver does.
+static uint64_t BenchmarkPackets(uint32_t iterations) {
+  uint64_t checksum = 0;
+  std::vector<std::unique_ptr<qosrtp::RtpPacket>> packets;
+  packets.reserve(iterations);
+  BenchmarkClock::time_point start = BenchmarkClock::now();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    packets.push_back(BuildPacket(static_cast<uint16_t>(i), i, false));
+  }
+  PrintResult("build", ElapsedNs(start), iterations);
+  std::vector<std::unique_ptr<qosrtp::DataBuffer>> buffers;
+  buffers.reserve(iterations);
+  start = BenchmarkClock::now();
+  for (const auto& pkt : packets) {
+    buffers.push_back(pkt->LoadPacket());
+  }
+  PrintResult("serialize", ElapsedNs(start), iterations);
+  packets.clear();
+  start = BenchmarkClock::now();
+  for (const auto& buffer : buffers) {
+    std::unique_ptr<qosrtp::RtpPacket> pkt = qosrtp::RtpPacket::Create();
+    if (!pkt->StorePacket(buffer->Get(), buffer->size())->ok()) continue;
+    checksum += pkt->sequence_number() + pkt->timestamp() + pkt->ssrc() +
+                pkt->payload_type() + pkt->GetPayloadBuffer()->size();
+    const qosrtp::DataBuffer* payload = pkt->GetPayloadBuffer();
+    for (uint32_t pos = 0; pos < payload->size(); pos += 64) {
+      checksum += *payload->At(pos);
+    }
+  }
+  PrintResult("parse", ElapsedNs(start), iterations);
+  return checksum;
+}
+
+// Encodes one frame once, then recovers its lost packets with a new
+// decoder in every round. Only Decode and Flush are timed.
+static uint64_t BenchmarkFecRecovery() {
+  uint64_t checksum = 0;
+  std::vector<std::unique_ptr<qosrtp::RtpPacket>> media_packets;
+  std::vector<const qosrtp::RtpPacket*> protected_packets;
+  for (uint32_t i = 0; i < global_config.nb_packets_per_frame; ++i) {
+    media_packets.push_back(BuildPacket(
+        static_cast<uint16_t>(i), 0,
+        i + 1 == global_config.nb_packets_per_frame));
+    protected_packets.push_back(media_packets.back().get());
+  }
+  std::unique_ptr<qosrtp::FecEncoderConfig> encoder_config =
+      qosrtp::FecEncoderConfig::Create();
+  encoder_config->Configure(global_config.ssrc,
+                            global_config.fec_payload_type);
+  std::unique_ptr<qosrtp::FecEncoder> encoder =
+      qosrtp::FecEncoder::Create(qosrtp::FecType::kUlp);
+  encoder->Configure(std::move(encoder_config));
+  std::vector<std::unique_ptr<qosrtp::RtpPacket>> fec_packets;
+  encoder->Encode(protected_packets, 0,
+                  qosrtp::ImportantPacketsProtectionMethod::kNone,
+                  global_config.protection_factor,
+                  qosrtp::FecMaskType::kFecMaskRandom, fec_packets);
+  std::vector<std::unique_ptr<qosrtp::DataBuffer>> received_buffers;
+  for (uint32_t i = 0; i < media_packets.size(); ++i) {
+    if (0 == (i + 1) % global_config.lost_packet_interval) continue;
+    received_buffers.push_back(media_packets[i]->LoadPacket());
+  }
+  uint16_t seq = static_cast<uint16_t>(media_packets.size());
+  for (auto& fec_packet : fec_packets) {
+    fec_packet->SetSequenceNumber(seq++);
+    fec_packet->SetTimestamp(0);
+    received_buffers.push_back(fec_packet->LoadPacket());
+  }
+  uint64_t elapsed_ns = 0;
+  uint64_t nb_recovered = 0;
+  for (uint32_t round = 0; round < global_config.nb_fec_rounds; ++round) {
+    std::unique_ptr<qosrtp::FecDecoderConfig> decoder_config =
+        qosrtp::FecDecoderConfig::Create();
+    decoder_config->Configure(static_cast<uint16_t>(seq), global_config.ssrc,
+                              global_config.fec_payload_type);
+    std::unique_ptr<qosrtp::FecDecoder> decoder =
+        qosrtp::FecDecoder::Create(qosrtp::FecType::kUlp);
+    decoder->Configure(std::move(decoder_config));
+    std::vector<std::unique_ptr<qosrtp::RtpPacket>> received_packets;
+    for (const auto& buffer : received_buffers) {
+      std::unique_ptr<qosrtp::RtpPacket> pkt = qosrtp::RtpPacket::Create();
+      pkt->StorePacket(buffer->Get(), buffer->size());
+      received_packets.push_back(std::move(pkt));
+    }
+    std::vector<std::unique_ptr<qosrtp::RtpPacket>> output_packets;
+    // The decoder may hand out a packet more than once, so each lost
+    // sequence number is counted once per round.
+    std::set<uint16_t> recovered_seqs;
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    decoder->Decode(std::move(received_packets), output_packets);
+    decoder->Flush(output_packets);
+    elapsed_ns += ElapsedNs(start);
+    for (const auto& pkt : output_packets) {
+      checksum += pkt->sequence_number();
+      if ((pkt->payload_type() == global_config.payload_type) &&
+          (0 == (pkt->sequence_number() + 1) %
+                    global_config.lost_packet_interval)) {
+        recovered_seqs.insert(pkt->sequence_number());
+      }
+    }
+    nb_recovered += recovered_seqs.size();
+  }
+  std::cout << "fec packets per frame: " << fec_packets.size()
+            << ", lost packets recovered per round: "
+            << nb_recovered / global_config.nb_fec_rounds << std::endl;
+  PrintResult("fec recovery", elapsed_ns, global_config.nb_fec_rounds);
+  return checksum;
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t iterations = global_config.default_iterations;
+  if (argc > 1) iterations = static_cast<uint32_t>(std::atoi(argv[1]));
+  if (0 == iterations) iterations = global_config.default_iterations;
+  qosrtp::QosrtpInterface::Initialize(nullptr,
+                                      qosrtp::QosrtpLogger::Level::kWarning);
+  uint64_t checksum = BenchmarkPackets(iterations);
+  checksum += BenchmarkFecRecovery();
+  // Keeps the reads above from being optimized away.
+  std::cout << "checksum: " << checksum << std::endl;
+  qosrtp::QosrtpInterface::UnInitialize();
+  return 0;
+}